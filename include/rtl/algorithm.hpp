@@ -10,10 +10,143 @@
  */
 #pragma once
 
+#include <rtl/int.hpp>
 #include <rtl/move.hpp>
+#include <rtl/type_traits.hpp>
+
+#if RTL_ENABLE_SIMD
+    #include <emmintrin.h>
+#endif
+
+#ifndef __GNUC__
+extern "C" void* __cdecl memcpy( void* dest, const void* src, decltype( sizeof( 0 ) ) count );
+extern "C" void* __cdecl memmove( void* dest, const void* src, decltype( sizeof( 0 ) ) count );
+extern "C" void* __cdecl memset( void* dest, int ch, decltype( sizeof( 0 ) ) count );
+#endif
 
 namespace rtl
 {
+    namespace impl
+    {
+        // NOTE: the blocks must not overlap, see move_bytes
+        inline void copy_bytes( void* dst, const void* src, size_t count )
+        {
+#ifdef __GNUC__
+            __builtin_memcpy( dst, src, count );
+#else
+            ::memcpy( dst, src, count );
+#endif
+        }
+
+        inline void move_bytes( void* dst, const void* src, size_t count )
+        {
+#ifdef __GNUC__
+            __builtin_memmove( dst, src, count );
+#else
+            ::memmove( dst, src, count );
+#endif
+        }
+
+        inline void fill_bytes( void* dst, uint8_t value, size_t count )
+        {
+#ifdef __GNUC__
+            __builtin_memset( dst, value, count );
+#else
+            ::memset( dst, value, count );
+#endif
+        }
+
+        // Copying T[] from U[] is a memcpy if the elements are bitwise copies of each other
+        template<typename OutputIterator, typename InputIterator>
+        struct is_bitwise_copyable : false_type
+        {
+        };
+
+        template<typename T, typename U>
+        struct is_bitwise_copyable<T*, U*>
+            : integral_constant<bool, is_same_v<T, remove_cv_t<U>> && is_trivially_copyable_v<T>>
+        {
+        };
+
+        // Filling T[] with a Value is a pattern store if no user-defined assignment is involved
+        template<typename Iterator, typename Value>
+        struct is_bitwise_fillable : false_type
+        {
+        };
+
+        template<typename T, typename Value>
+        struct is_bitwise_fillable<T*, Value>
+            : integral_constant<bool,
+                                ( is_same_v<T, remove_cv_t<Value>> && is_trivially_copyable_v<T> )
+                                    || ( is_integral_v<T> && is_integral_v<Value> )>
+        {
+        };
+
+#if RTL_ENABLE_SIMD
+        template<typename T>
+        inline void fill_broadcast( T* first, size_t count, T value )
+        {
+            static_assert( sizeof( T ) == 1 || sizeof( T ) == 2 || sizeof( T ) == 4 );
+
+            __m128i pattern;
+
+            if constexpr ( sizeof( T ) == 1 )
+                pattern = _mm_set1_epi8( __builtin_bit_cast( char, value ) );
+            else if constexpr ( sizeof( T ) == 2 )
+                pattern = _mm_set1_epi16( __builtin_bit_cast( short, value ) );
+            else
+                pattern = _mm_set1_epi32( __builtin_bit_cast( int, value ) );
+
+            constexpr size_t lanes = 16 / sizeof( T );
+
+            if ( count < lanes )
+            {
+                for ( ; count; --count )
+                    *first++ = value;
+
+                return;
+            }
+
+            size_t i = 0;
+
+            for ( ; i + 2 * lanes <= count; i += 2 * lanes )
+            {
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( first + i ), pattern );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( first + i + lanes ), pattern );
+            }
+
+            if ( i + lanes <= count )
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( first + i ), pattern );
+
+            // NOTE: the tail overlaps already filled elements
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( first + count - lanes ), pattern );
+        }
+#endif
+
+        template<typename T, typename Value>
+        inline void fill_pattern( T* first, size_t count, const Value& value )
+        {
+            const T pattern = static_cast<T>( value );
+
+            if constexpr ( sizeof( T ) == 1 || sizeof( T ) == 2 || sizeof( T ) == 4 )
+            {
+#if RTL_ENABLE_SIMD
+                fill_broadcast( first, count, pattern );
+                return;
+#else
+                if constexpr ( sizeof( T ) == 1 )
+                {
+                    fill_bytes( first, __builtin_bit_cast( uint8_t, pattern ), count );
+                    return;
+                }
+#endif
+            }
+
+            for ( ; count; --count )
+                *first++ = pattern;
+        }
+    } // namespace impl
+
     template<typename T>
     constexpr void swap( T& t1, T& t2 )
     {
@@ -46,9 +179,22 @@ namespace rtl
         return val < T( 0 ) ? -val : val;
     }
 
+    // NOTE: like the element loop, a range may be copied over itself towards its start, so the
+    // bulk path has memmove semantics
     template<typename InputIterator, typename Size, typename OutputIterator>
     constexpr OutputIterator copy_n( InputIterator src, Size count, OutputIterator dst )
     {
+        if constexpr ( impl::is_bitwise_copyable<OutputIterator, InputIterator>::value )
+        {
+            if ( !rtl::is_constant_evaluated() )
+            {
+                if ( count > 0 )
+                    impl::move_bytes( dst, src, static_cast<size_t>( count ) * sizeof( *dst ) );
+
+                return dst + count;
+            }
+        }
+
         for ( auto last = dst + count; dst != last; )
             *dst++ = *src++;
 
@@ -58,6 +204,17 @@ namespace rtl
     template<typename Iterator, typename Size, typename Value>
     constexpr Iterator fill_n( Iterator first, Size count, const Value& value )
     {
+        if constexpr ( impl::is_bitwise_fillable<Iterator, Value>::value )
+        {
+            if ( !rtl::is_constant_evaluated() )
+            {
+                if ( count > 0 )
+                    impl::fill_pattern( first, static_cast<size_t>( count ), value );
+
+                return first + count;
+            }
+        }
+
         for ( auto last = first + count; first != last; ++first )
             *first = value;
 
@@ -67,6 +224,12 @@ namespace rtl
     template<typename Iterator, typename Value>
     constexpr void fill( Iterator first, Iterator last, const Value& value )
     {
+        if constexpr ( impl::is_bitwise_fillable<Iterator, Value>::value )
+        {
+            rtl::fill_n( first, last - first, value );
+            return;
+        }
+
         for ( ; first != last; ++first )
             *first = value;
     }
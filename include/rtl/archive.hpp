@@ -0,0 +1,195 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/fourcc.hpp>
+#include <rtl/int.hpp>
+#include <rtl/span.hpp>
+#include <rtl/string.hpp>
+
+#include <rtl/sys/debug.hpp>
+
+namespace rtl
+{
+    // Packed read-only archive of files, built by the rtl_pack tool. Layout, little-endian:
+    //   archive_header
+    //   archive_entry[count], sorted by name
+    //   names, UTF-8 with '/' separators and without terminating zeros
+    //   contents, each one aligned to archive_alignment
+    constexpr uint32_t archive_magic = make_fourcc( 'R', 'T', 'L', 'A' );
+    constexpr uint32_t archive_version = 1;
+    constexpr uint32_t archive_alignment = 16;
+
+    struct archive_header
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t count;
+        uint32_t names_size;
+    };
+
+    struct archive_entry
+    {
+        uint32_t name_offset; // from the start of the names
+        uint32_t name_size;
+        uint32_t type;        // fourcc tag
+        uint32_t offset;      // from the start of the archive
+        uint32_t size;
+    };
+
+    static_assert( sizeof( archive_header ) == 16 );
+    static_assert( sizeof( archive_entry ) == 20 );
+
+    namespace impl
+    {
+        // Byte-wise order, the same as the one the archive index is sorted in
+        [[nodiscard]] constexpr int compare_bytes( const string_view& lhs, const string_view& rhs )
+        {
+            const size_t size = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+
+            for ( size_t i = 0; i < size; ++i )
+            {
+                const uint8_t a = static_cast<uint8_t>( lhs[i] );
+                const uint8_t b = static_cast<uint8_t>( rhs[i] );
+
+                if ( a != b )
+                    return a < b ? -1 : 1;
+            }
+
+            return lhs.size() < rhs.size() ? -1 : ( lhs.size() > rhs.size() ? 1 : 0 );
+        }
+    } // namespace impl
+
+    // Index over the bytes of an archive, usually a filesystem::mapped_file. Nothing is copied,
+    // names and contents point into the bytes, which must outlive the object.
+    class archive final
+    {
+    public:
+        struct file
+        {
+            string_view         name;
+            uint32_t            type;
+            span<const uint8_t> data;
+        };
+
+        archive() = default;
+
+        explicit archive( span<const uint8_t> bytes )
+        {
+            open( bytes );
+        }
+
+        // Checks the header and that all names and contents lie within the bytes
+        bool open( span<const uint8_t> bytes )
+        {
+            m_entries = nullptr;
+            m_count = 0;
+
+            if ( bytes.size() < sizeof( archive_header ) )
+                return false;
+
+            const archive_header& header = *reinterpret_cast<const archive_header*>( bytes.data() );
+
+            if ( header.magic != archive_magic || header.version != archive_version )
+                return false;
+
+            const size_t available = bytes.size() - sizeof( archive_header );
+
+            if ( header.count > available / sizeof( archive_entry ) )
+                return false;
+
+            const size_t index_size = header.count * sizeof( archive_entry );
+
+            if ( header.names_size > available - index_size )
+                return false;
+
+            const archive_entry* entries
+                = reinterpret_cast<const archive_entry*>( bytes.data() + sizeof( archive_header ) );
+
+            for ( uint32_t i = 0; i < header.count; ++i )
+            {
+                const archive_entry& e = entries[i];
+
+                if ( e.name_size > header.names_size
+                     || e.name_offset > header.names_size - e.name_size )
+                {
+                    return false;
+                }
+
+                if ( e.size > bytes.size() || e.offset > bytes.size() - e.size )
+                    return false;
+            }
+
+            m_bytes = bytes.data();
+            m_entries = entries;
+            m_names = reinterpret_cast<const char*>( entries + header.count );
+            m_count = header.count;
+
+            return true;
+        }
+
+        bool is_open() const
+        {
+            return m_entries != nullptr;
+        }
+
+        size_t size() const
+        {
+            return m_count;
+        }
+
+        file operator[]( size_t index ) const
+        {
+            RTL_ASSERT( index < m_count );
+
+            const archive_entry& e = m_entries[index];
+
+            return file{ name( e ), e.type, span<const uint8_t>( m_bytes + e.offset, e.size ) };
+        }
+
+        // Binary search by the full name, e.g. "textures/logo.png"
+        bool find( const string_view& name, file& result ) const
+        {
+            size_t first = 0;
+            size_t last = m_count;
+
+            while ( first < last )
+            {
+                const size_t middle = first + ( last - first ) / 2;
+                const int    order = impl::compare_bytes( this->name( m_entries[middle] ), name );
+
+                if ( order == 0 )
+                {
+                    result = ( *this )[middle];
+                    return true;
+                }
+
+                if ( order < 0 )
+                    first = middle + 1;
+                else
+                    last = middle;
+            }
+
+            return false;
+        }
+
+    private:
+        string_view name( const archive_entry& e ) const
+        {
+            return string_view( m_names + e.name_offset, e.name_size );
+        }
+
+        const uint8_t*       m_bytes = nullptr;
+        const archive_entry* m_entries = nullptr;
+        const char*          m_names = nullptr;
+        size_t               m_count = 0;
+    };
+} // namespace rtl
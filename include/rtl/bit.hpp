@@ -0,0 +1,399 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/int.hpp>
+#include <rtl/type_traits.hpp>
+
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+// NOTE: POPCNT is not part of the x86 baseline, MSVC emits it unconditionally for __popcnt
+#if defined( __POPCNT__ ) || defined( __AVX__ )
+    #define RTL_IMPL_HAS_POPCNT 1
+#else
+    #define RTL_IMPL_HAS_POPCNT 0
+#endif
+
+namespace rtl
+{
+    namespace impl
+    {
+        namespace bit
+        {
+            template<typename T>
+            inline constexpr int digits = static_cast<int>( sizeof( T ) * 8 );
+
+            template<typename T>
+            inline constexpr bool is_word
+                = is_unsigned_v<T> && !is_same_v<remove_cv_t<T>, bool> && sizeof( T ) <= 8;
+
+            // NOTE: if x == 0, then result is undefined
+            [[nodiscard]] constexpr int clz32_generic( uint32_t x )
+            {
+                int n = 0;
+
+                // clang-format off
+                if ( x <= 0x0000FFFFu ) { n += 16; x <<= 16; }
+                if ( x <= 0x00FFFFFFu ) { n += 8;  x <<= 8; }
+                if ( x <= 0x0FFFFFFFu ) { n += 4;  x <<= 4; }
+                if ( x <= 0x3FFFFFFFu ) { n += 2;  x <<= 2; }
+                if ( x <= 0x7FFFFFFFu ) { n += 1; }
+                // clang-format on
+
+                return n;
+            }
+
+            // NOTE: if x == 0, then result is undefined
+            [[nodiscard]] constexpr int ctz32_generic( uint32_t x )
+            {
+                int n = 0;
+
+                // clang-format off
+                if ( ( x & 0x0000FFFFu ) == 0 ) { n += 16; x >>= 16; }
+                if ( ( x & 0x000000FFu ) == 0 ) { n += 8;  x >>= 8; }
+                if ( ( x & 0x0000000Fu ) == 0 ) { n += 4;  x >>= 4; }
+                if ( ( x & 0x00000003u ) == 0 ) { n += 2;  x >>= 2; }
+                if ( ( x & 0x00000001u ) == 0 ) { n += 1; }
+                // clang-format on
+
+                return n;
+            }
+
+            [[nodiscard]] constexpr int popcount32_generic( uint32_t x )
+            {
+                x = x - ( ( x >> 1 ) & 0x55555555u );
+                x = ( x & 0x33333333u ) + ( ( x >> 2 ) & 0x33333333u );
+                x = ( x + ( x >> 4 ) ) & 0x0F0F0F0Fu;
+
+                return static_cast<int>( ( x * 0x01010101u ) >> 24 );
+            }
+
+            // NOTE: if x == 0, then result is undefined
+            [[nodiscard]] constexpr int clz32( uint32_t x )
+            {
+#ifdef __GNUC__
+                return __builtin_clz( x );
+#else
+                if ( is_constant_evaluated() )
+                    return clz32_generic( x );
+
+                unsigned long index;
+                _BitScanReverse( &index, x );
+                return 31 - static_cast<int>( index );
+#endif
+            }
+
+            // NOTE: if x == 0, then result is undefined
+            [[nodiscard]] constexpr int clz64( uint64_t x )
+            {
+#ifdef __GNUC__
+                return __builtin_clzll( x );
+#elif defined( _M_X64 )
+                if ( is_constant_evaluated() )
+                {
+                    const uint32_t high = static_cast<uint32_t>( x >> 32 );
+                    return high ? clz32_generic( high )
+                                : 32 + clz32_generic( static_cast<uint32_t>( x ) );
+                }
+
+                unsigned long index;
+                _BitScanReverse64( &index, x );
+                return 63 - static_cast<int>( index );
+#else
+                const uint32_t high = static_cast<uint32_t>( x >> 32 );
+                return high ? clz32( high ) : 32 + clz32( static_cast<uint32_t>( x ) );
+#endif
+            }
+
+            // NOTE: if x == 0, then result is undefined
+            [[nodiscard]] constexpr int ctz32( uint32_t x )
+            {
+#ifdef __GNUC__
+                return __builtin_ctz( x );
+#else
+                if ( is_constant_evaluated() )
+                    return ctz32_generic( x );
+
+                unsigned long index;
+                _BitScanForward( &index, x );
+                return static_cast<int>( index );
+#endif
+            }
+
+            // NOTE: if x == 0, then result is undefined
+            [[nodiscard]] constexpr int ctz64( uint64_t x )
+            {
+#ifdef __GNUC__
+                return __builtin_ctzll( x );
+#elif defined( _M_X64 )
+                if ( is_constant_evaluated() )
+                {
+                    const uint32_t low = static_cast<uint32_t>( x );
+                    return low ? ctz32_generic( low )
+                               : 32 + ctz32_generic( static_cast<uint32_t>( x >> 32 ) );
+                }
+
+                unsigned long index;
+                _BitScanForward64( &index, x );
+                return static_cast<int>( index );
+#else
+                const uint32_t low = static_cast<uint32_t>( x );
+                return low ? ctz32( low ) : 32 + ctz32( static_cast<uint32_t>( x >> 32 ) );
+#endif
+            }
+
+            [[nodiscard]] constexpr int popcount32( uint32_t x )
+            {
+#ifdef __GNUC__
+                return __builtin_popcount( x );
+#elif defined( _MSC_VER ) && RTL_IMPL_HAS_POPCNT
+                if ( is_constant_evaluated() )
+                    return popcount32_generic( x );
+
+                return static_cast<int>( __popcnt( x ) );
+#else
+                return popcount32_generic( x );
+#endif
+            }
+
+            [[nodiscard]] constexpr int popcount64( uint64_t x )
+            {
+#ifdef __GNUC__
+                return __builtin_popcountll( x );
+#elif defined( _MSC_VER ) && defined( _M_X64 ) && RTL_IMPL_HAS_POPCNT
+                if ( is_constant_evaluated() )
+                    return popcount32( static_cast<uint32_t>( x ) )
+                           + popcount32( static_cast<uint32_t>( x >> 32 ) );
+
+                return static_cast<int>( __popcnt64( x ) );
+#else
+                return popcount32( static_cast<uint32_t>( x ) )
+                       + popcount32( static_cast<uint32_t>( x >> 32 ) );
+#endif
+            }
+
+            // 1 << n without variable 64-bit shifts, which are CRT helpers on MSVC x86
+            template<typename T>
+            [[nodiscard]] constexpr T single_bit( int n )
+            {
+                if constexpr ( sizeof( T ) == 8 )
+                {
+                    return n < 32 ? static_cast<T>( 1u << n )
+                                  : static_cast<T>( static_cast<uint64_t>( 1u << ( n - 32 ) )
+                                                    << 32 );
+                }
+                else
+                {
+                    return static_cast<T>( 1u << n );
+                }
+            }
+
+            // x << n for n in [0, 63], from 32-bit halves like single_bit
+            [[nodiscard]] constexpr uint64_t shl64( uint64_t x, int n )
+            {
+                const uint32_t low = static_cast<uint32_t>( x );
+                const uint32_t high = static_cast<uint32_t>( x >> 32 );
+
+                if ( n == 0 )
+                    return x;
+
+                if ( n >= 32 )
+                    return static_cast<uint64_t>( low << ( n - 32 ) ) << 32;
+
+                return ( static_cast<uint64_t>( ( high << n ) | ( low >> ( 32 - n ) ) ) << 32 )
+                       | static_cast<uint32_t>( low << n );
+            }
+
+            // x >> n for n in [0, 63], from 32-bit halves like single_bit
+            [[nodiscard]] constexpr uint64_t shr64( uint64_t x, int n )
+            {
+                const uint32_t low = static_cast<uint32_t>( x );
+                const uint32_t high = static_cast<uint32_t>( x >> 32 );
+
+                if ( n == 0 )
+                    return x;
+
+                if ( n >= 32 )
+                    return high >> ( n - 32 );
+
+                return ( static_cast<uint64_t>( high >> n ) << 32 )
+                       | ( ( low >> n ) | ( high << ( 32 - n ) ) );
+            }
+        } // namespace bit
+    }     // namespace impl
+
+    template<typename T>
+    [[nodiscard]] constexpr int countl_zero( T x )
+    {
+        static_assert( impl::bit::is_word<T>, "rtl::countl_zero requires an unsigned integer" );
+
+        if ( x == 0 )
+            return impl::bit::digits<T>;
+
+        if constexpr ( sizeof( T ) == 8 )
+            return impl::bit::clz64( x );
+        else
+            return impl::bit::clz32( x ) - ( 32 - impl::bit::digits<T> );
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr int countr_zero( T x )
+    {
+        static_assert( impl::bit::is_word<T>, "rtl::countr_zero requires an unsigned integer" );
+
+        if ( x == 0 )
+            return impl::bit::digits<T>;
+
+        if constexpr ( sizeof( T ) == 8 )
+            return impl::bit::ctz64( x );
+        else
+            return impl::bit::ctz32( x );
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr int countl_one( T x )
+    {
+        return countl_zero( static_cast<T>( ~x ) );
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr int countr_one( T x )
+    {
+        return countr_zero( static_cast<T>( ~x ) );
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr int popcount( T x )
+    {
+        static_assert( impl::bit::is_word<T>, "rtl::popcount requires an unsigned integer" );
+
+        if constexpr ( sizeof( T ) == 8 )
+            return impl::bit::popcount64( x );
+        else
+            return impl::bit::popcount32( x );
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr bool has_single_bit( T x )
+    {
+        static_assert( impl::bit::is_word<T>, "rtl::has_single_bit requires an unsigned integer" );
+
+        return x != 0 && ( x & ( x - 1 ) ) == 0;
+    }
+
+    // Number of bits needed to represent x, 0 for x == 0
+    template<typename T>
+    [[nodiscard]] constexpr int bit_width( T x )
+    {
+        return impl::bit::digits<T> - countl_zero( x );
+    }
+
+    // Largest power of two not greater than x, 0 for x == 0
+    template<typename T>
+    [[nodiscard]] constexpr T bit_floor( T x )
+    {
+        return x == 0 ? T( 0 ) : impl::bit::single_bit<T>( bit_width( x ) - 1 );
+    }
+
+    // Smallest power of two not less than x
+    // NOTE: if the result is not representable in T, then result is undefined
+    template<typename T>
+    [[nodiscard]] constexpr T bit_ceil( T x )
+    {
+        return x <= 1 ? T( 1 ) : impl::bit::single_bit<T>( bit_width( T( x - 1 ) ) );
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr T rotl( T x, int s )
+    {
+        static_assert( impl::bit::is_word<T>, "rtl::rotl requires an unsigned integer" );
+
+        constexpr int  digits = impl::bit::digits<T>;
+        const unsigned count = static_cast<unsigned>( s ) & ( digits - 1 );
+
+#ifdef _MSC_VER
+        if ( !is_constant_evaluated() )
+        {
+            if constexpr ( sizeof( T ) == 8 )
+                return _rotl64( x, static_cast<int>( count ) );
+            else if constexpr ( sizeof( T ) == 4 )
+                return _rotl( x, static_cast<int>( count ) );
+        }
+#endif
+        if ( count == 0 )
+            return x;
+
+        return static_cast<T>( ( x << count ) | ( x >> ( digits - count ) ) );
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr T rotr( T x, int s )
+    {
+        return rotl( x, -s );
+    }
+
+    template<typename T>
+    [[nodiscard]] constexpr T byteswap( T x )
+    {
+        static_assert( is_integral_v<T>, "rtl::byteswap requires an integer" );
+
+        if constexpr ( sizeof( T ) == 1 )
+        {
+            return x;
+        }
+        else if constexpr ( sizeof( T ) == 2 )
+        {
+#ifdef __GNUC__
+            return static_cast<T>( __builtin_bswap16( static_cast<uint16_t>( x ) ) );
+#else
+            if ( !is_constant_evaluated() )
+                return static_cast<T>( _byteswap_ushort( static_cast<uint16_t>( x ) ) );
+
+            const uint16_t value = static_cast<uint16_t>( x );
+            return static_cast<T>( static_cast<uint16_t>( ( value << 8 ) | ( value >> 8 ) ) );
+#endif
+        }
+        else if constexpr ( sizeof( T ) == 4 )
+        {
+#ifdef __GNUC__
+            return static_cast<T>( __builtin_bswap32( static_cast<uint32_t>( x ) ) );
+#else
+            if ( !is_constant_evaluated() )
+                return static_cast<T>( _byteswap_ulong( static_cast<uint32_t>( x ) ) );
+
+            const uint32_t value = static_cast<uint32_t>( x );
+            return static_cast<T>( ( value << 24 ) | ( ( value << 8 ) & 0x00FF0000u )
+                                   | ( ( value >> 8 ) & 0x0000FF00u ) | ( value >> 24 ) );
+#endif
+        }
+        else
+        {
+            static_assert( sizeof( T ) == 8, "rtl::byteswap: unsupported integer size" );
+
+#ifdef __GNUC__
+            return static_cast<T>( __builtin_bswap64( static_cast<uint64_t>( x ) ) );
+#else
+            if ( !is_constant_evaluated() )
+                return static_cast<T>( _byteswap_uint64( static_cast<uint64_t>( x ) ) );
+
+            const uint64_t value = static_cast<uint64_t>( x );
+
+            return static_cast<T>(
+                ( static_cast<uint64_t>( byteswap( static_cast<uint32_t>( value ) ) ) << 32 )
+                | byteswap( static_cast<uint32_t>( value >> 32 ) ) );
+#endif
+        }
+    }
+} // namespace rtl
+
+#undef RTL_IMPL_HAS_POPCNT
@@ -0,0 +1,542 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/array.hpp>
+#include <rtl/bit.hpp>
+#include <rtl/int.hpp>
+#include <rtl/math.hpp>
+
+namespace rtl
+{
+    enum class errc
+    {
+        ok,
+        value_too_large,
+    };
+
+    template<typename Char>
+    struct to_chars_result
+    {
+        Char* ptr;
+        errc  ec;
+    };
+
+    namespace impl
+    {
+        // Grisu2 shortest floating-point to decimal conversion.
+        // Florian Loitsch, "Printing Floating-Point Numbers Quickly and Accurately with Integers"
+        // https://www.cs.tufts.edu/~nr/cs257/archive/florian-loitsch/printf.pdf
+        //
+        // The output always round-trips and is the shortest one for all but a tiny fraction of
+        // inputs, where one extra digit may be produced.
+        namespace grisu
+        {
+            template<typename Float>
+            struct float_traits;
+
+            template<>
+            struct float_traits<double>
+            {
+                using bits_type = uint64_t;
+
+                static constexpr int digits = 53;
+                static constexpr int max_exponent = 1024;
+            };
+
+            template<>
+            struct float_traits<float>
+            {
+                using bits_type = uint32_t;
+
+                static constexpr int digits = 24;
+                static constexpr int max_exponent = 128;
+            };
+
+            // "do-it-yourself floating point": f * 2^e
+            struct diyfp
+            {
+                uint64_t f;
+                int      e;
+            };
+
+            [[nodiscard]] constexpr diyfp sub( const diyfp& x, const diyfp& y )
+            {
+                return diyfp{ x.f - y.f, x.e };
+            }
+
+            // NOTE: the result is rounded to the upper 64 bits of the product
+            [[nodiscard]] constexpr diyfp mul( const diyfp& x, const diyfp& y )
+            {
+                uint64_t       high = 0;
+                const uint64_t low = rtl::umul128( x.f, y.f, high );
+
+                // round, ties up
+                if ( low >> 63 )
+                    ++high;
+
+                return diyfp{ high, x.e + y.e + 64 };
+            }
+
+            // NOTE: if x.f == 0, then result is undefined
+            [[nodiscard]] constexpr diyfp normalize( diyfp x )
+            {
+                const int shift = countl_zero( x.f );
+
+                return diyfp{ impl::bit::shl64( x.f, shift ), x.e - shift };
+            }
+
+            [[nodiscard]] constexpr diyfp normalize_to( const diyfp& x, int target_exponent )
+            {
+                return diyfp{ impl::bit::shl64( x.f, x.e - target_exponent ), target_exponent };
+            }
+
+            struct boundaries
+            {
+                diyfp w;
+                diyfp minus;
+                diyfp plus;
+            };
+
+            // NOTE: value must be finite and positive
+            template<typename Float>
+            [[nodiscard]] boundaries compute_boundaries( Float value )
+            {
+                using traits = float_traits<Float>;
+
+                constexpr int      precision = traits::digits;
+                constexpr int      bias = traits::max_exponent - 1 + ( precision - 1 );
+                constexpr int      min_exp = 1 - bias;
+                constexpr uint64_t hidden_bit = uint64_t( 1 ) << ( precision - 1 );
+
+                const uint64_t bits = __builtin_bit_cast( typename traits::bits_type, value );
+                const int      exponent = static_cast<int>( bits >> ( precision - 1 ) );
+                const uint64_t fraction = bits & ( hidden_bit - 1 );
+
+                const diyfp v = exponent == 0 ? diyfp{ fraction, min_exp }
+                                              : diyfp{ fraction + hidden_bit, exponent - bias };
+
+                // The lower boundary is closer if the value is a power of two (and not the
+                // smallest normal)
+                const bool lower_boundary_is_closer = fraction == 0 && exponent > 1;
+
+                const diyfp m_plus{ 2 * v.f + 1, v.e - 1 };
+                const diyfp m_minus = lower_boundary_is_closer ? diyfp{ 4 * v.f - 1, v.e - 2 }
+                                                               : diyfp{ 2 * v.f - 1, v.e - 1 };
+
+                const diyfp w_plus = normalize( m_plus );
+                const diyfp w_minus = normalize_to( m_minus, w_plus.e );
+
+                return boundaries{ normalize( v ), w_minus, w_plus };
+            }
+
+            // Normalized 10^k = f * 2^e
+            struct cached_power
+            {
+                uint64_t f;
+                int      e;
+                int      k;
+            };
+
+            constexpr int alpha = -60;
+            constexpr int gamma = -32;
+
+            constexpr int cached_powers_min_dec_exp = -300;
+            constexpr int cached_powers_dec_step = 8;
+            constexpr int cached_powers_count = 79;
+
+            // 192-bit binary approximation of a power of ten, the top bit of m[5] is always set
+            class power_of_ten final
+            {
+            public:
+                constexpr power_of_ten()
+                    : m{ 0, 0, 0, 0, 0, 0x80000000u }
+                    , e( -191 )
+                {
+                }
+
+                constexpr void multiply( uint32_t factor )
+                {
+                    uint32_t product[limbs + 1]{};
+                    uint64_t carry = 0;
+
+                    for ( int i = 0; i < limbs; ++i )
+                    {
+                        const uint64_t t = static_cast<uint64_t>( m[i] ) * factor + carry;
+                        product[i] = static_cast<uint32_t>( t );
+                        carry = t >> 32;
+                    }
+
+                    product[limbs] = static_cast<uint32_t>( carry );
+
+                    load( product, e );
+                }
+
+                constexpr void divide( uint32_t divisor )
+                {
+                    // NOTE: one extra low limb keeps the precision after the division
+                    uint32_t quotient[limbs + 1]{};
+                    uint64_t remainder = 0;
+
+                    for ( int i = limbs; i >= 0; --i )
+                    {
+                        const uint64_t t = ( remainder << 32 ) | ( i > 0 ? m[i - 1] : 0u );
+                        quotient[i] = static_cast<uint32_t>( t / divisor );
+                        remainder = t % divisor;
+                    }
+
+                    load( quotient, e - 32 );
+                }
+
+                [[nodiscard]] constexpr cached_power round( int k ) const
+                {
+                    uint64_t f = ( static_cast<uint64_t>( m[5] ) << 32 ) | m[4];
+                    int      exponent = e + 128;
+
+                    if ( m[3] >> 31 )
+                    {
+                        if ( ++f == 0 )
+                        {
+                            f = uint64_t( 1 ) << 63;
+                            ++exponent;
+                        }
+                    }
+
+                    return cached_power{ f, exponent, k };
+                }
+
+            private:
+                static constexpr int limbs = 6;
+
+                // Normalizes a value of (limbs + 1) limbs back into m
+                constexpr void load( const uint32_t ( &value )[limbs + 1], int exponent )
+                {
+                    int top = limbs;
+
+                    while ( value[top] == 0 )
+                        --top;
+
+                    const int shift = countl_zero( value[top] );
+
+                    // take 192 bits starting from the leading one
+                    for ( int i = limbs - 1; i >= 0; --i )
+                    {
+                        const int      src = top - ( limbs - 1 - i );
+                        const uint32_t hi = src >= 0 ? value[src] : 0u;
+                        const uint32_t lo = src > 0 ? value[src - 1] : 0u;
+
+                        m[i] = shift ? ( hi << shift ) | ( lo >> ( 32 - shift ) ) : hi;
+                    }
+
+                    e = exponent + ( top - ( limbs - 1 ) ) * 32 - shift;
+                }
+
+                uint32_t m[limbs];
+                int      e;
+            };
+
+            [[nodiscard]] constexpr rtl::array<cached_power, cached_powers_count>
+            make_cached_powers()
+            {
+                rtl::array<cached_power, cached_powers_count> table{};
+
+                power_of_ten power;
+
+                int k = 0;
+
+                for ( ; k - cached_powers_dec_step >= cached_powers_min_dec_exp;
+                      k -= cached_powers_dec_step )
+                    power.divide( 100000000u );
+
+                for ( ; k > cached_powers_min_dec_exp; --k )
+                    power.divide( 10 );
+
+                for ( int i = 0; i < cached_powers_count; ++i )
+                {
+                    table[i] = power.round( k );
+                    power.multiply( 100000000u );
+                    k += cached_powers_dec_step;
+                }
+
+                return table;
+            }
+
+            struct cached_powers final
+            {
+                static constexpr rtl::array<cached_power, cached_powers_count> table
+                    = make_cached_powers();
+            };
+
+            // Returns c = 10^k such that alpha <= c.e + e + 64 <= gamma
+            [[nodiscard]] constexpr cached_power get_cached_power( int e )
+            {
+                const int f = alpha - e - 1;
+                const int k = ( f * 78913 ) / ( 1 << 18 ) + ( f > 0 );
+
+                const int index
+                    = ( -cached_powers_min_dec_exp + k + ( cached_powers_dec_step - 1 ) )
+                      / cached_powers_dec_step;
+
+                return cached_powers::table[index];
+            }
+
+            [[nodiscard]] constexpr int find_largest_pow10( uint32_t n, uint32_t& pow10 )
+            {
+                int      digits = 1;
+                uint32_t p = 1;
+
+                for ( ; digits < 10 && n / p >= 10; ++digits )
+                    p *= 10;
+
+                pow10 = p;
+                return digits;
+            }
+
+            constexpr void round_weed( char*    buffer,
+                                       int      length,
+                                       uint64_t dist,
+                                       uint64_t delta,
+                                       uint64_t rest,
+                                       uint64_t ten_k )
+            {
+                while ( rest < dist && delta - rest >= ten_k
+                        && ( rest + ten_k < dist || dist - rest > rest + ten_k - dist ) )
+                {
+                    --buffer[length - 1];
+                    rest += ten_k;
+                }
+            }
+
+            constexpr void generate_digits( char*        buffer,
+                                            int&         length,
+                                            int&         decimal_exponent,
+                                            const diyfp& m_minus,
+                                            const diyfp& w,
+                                            const diyfp& m_plus )
+            {
+                uint64_t delta = sub( m_plus, m_minus ).f;
+                uint64_t dist = sub( m_plus, w ).f;
+
+                // NOTE: shift is in [32, 60], the 64-bit shifts and products below are built
+                // from 32-bit halves, so MSVC x86 does not call CRT helpers for them
+                const int      shift = -m_plus.e;
+                const uint64_t one = impl::bit::single_bit<uint64_t>( shift );
+
+                uint32_t p1 = static_cast<uint32_t>( impl::bit::shr64( m_plus.f, shift ) );
+                uint64_t p2 = m_plus.f & ( one - 1 );
+
+                uint32_t pow10 = 0;
+                int      n = find_largest_pow10( p1, pow10 );
+
+                while ( n > 0 )
+                {
+                    buffer[length++] = static_cast<char>( '0' + p1 / pow10 );
+                    p1 %= pow10;
+                    --n;
+
+                    const uint64_t rest = impl::bit::shl64( p1, shift ) + p2;
+
+                    if ( rest <= delta )
+                    {
+                        decimal_exponent += n;
+                        round_weed( buffer,
+                                    length,
+                                    dist,
+                                    delta,
+                                    rest,
+                                    impl::bit::shl64( pow10, shift ) );
+                        return;
+                    }
+
+                    pow10 /= 10;
+                }
+
+                int m = 0;
+
+                for ( ;; )
+                {
+                    p2 = mul64( p2, 10 );
+                    buffer[length++] = static_cast<char>( '0' + impl::bit::shr64( p2, shift ) );
+                    p2 &= one - 1;
+                    ++m;
+
+                    delta = mul64( delta, 10 );
+                    dist = mul64( dist, 10 );
+
+                    if ( p2 <= delta )
+                        break;
+                }
+
+                decimal_exponent -= m;
+                round_weed( buffer, length, dist, delta, p2, one );
+            }
+
+            // Produces digits of value = buffer * 10^decimal_exponent
+            // NOTE: value must be finite and positive, buffer must hold 17 digits
+            template<typename Float>
+            void grisu2( char* buffer, int& length, int& decimal_exponent, Float value )
+            {
+                const boundaries b = compute_boundaries( value );
+
+                const cached_power cached = get_cached_power( b.plus.e );
+                const diyfp        c{ cached.f, cached.e };
+
+                const diyfp w = mul( b.w, c );
+                const diyfp w_minus = mul( b.minus, c );
+                const diyfp w_plus = mul( b.plus, c );
+
+                // Shrink the interval by 1 ulp at both ends to account for rounding errors
+                const diyfp m_minus{ w_minus.f + 1, w_minus.e };
+                const diyfp m_plus{ w_plus.f - 1, w_plus.e };
+
+                length = 0;
+                decimal_exponent = -cached.k;
+
+                generate_digits( buffer, length, decimal_exponent, m_minus, w, m_plus );
+            }
+        } // namespace grisu
+
+        template<typename Char>
+        [[nodiscard]] constexpr Char* copy_chars( Char* dst, const char* src )
+        {
+            for ( ; *src; ++src )
+                *dst++ = static_cast<Char>( *src );
+
+            return dst;
+        }
+
+        template<typename Char>
+        [[nodiscard]] constexpr Char* fill_chars( Char* dst, int count, char ch )
+        {
+            for ( ; count > 0; --count )
+                *dst++ = static_cast<Char>( ch );
+
+            return dst;
+        }
+    } // namespace impl
+
+    // Converts value to the shortest representation that parses back to the same value, selecting
+    // fixed or scientific notation by the smaller number of characters (like std::to_chars does).
+    // NOTE: 24 characters are always enough for double, 15 for float
+    template<typename Char, typename Float>
+    to_chars_result<Char> to_chars( Char* first, Char* last, Float value )
+    {
+        using traits = impl::grisu::float_traits<Float>;
+        using bits_type = typename traits::bits_type;
+
+        constexpr int       total_bits = sizeof( bits_type ) * 8;
+        constexpr bits_type sign_mask = bits_type( 1 ) << ( total_bits - 1 );
+        constexpr bits_type exponent_mask
+            = ( ~bits_type( 0 ) >> 1 ) & ~( ( bits_type( 1 ) << ( traits::digits - 1 ) ) - 1 );
+
+        const bits_type bits = __builtin_bit_cast( bits_type, value );
+        const bool      negative = ( bits & sign_mask ) != 0;
+
+        char  text[32];
+        char* out = text;
+
+        if ( negative && ( bits & exponent_mask ) != exponent_mask )
+            *out++ = '-';
+
+        if ( ( bits & exponent_mask ) == exponent_mask )
+        {
+            out = impl::copy_chars( out, ( bits & ~( sign_mask | exponent_mask ) ) ? "nan"
+                                         : negative                                 ? "-inf"
+                                                                                    : "inf" );
+        }
+        else if ( ( bits & ~sign_mask ) == 0 )
+        {
+            *out++ = '0';
+        }
+        else
+        {
+            char digits[17];
+            int  k = 0;
+            int  exponent = 0;
+
+            impl::grisu::grisu2( digits, k, exponent, negative ? -value : value );
+
+            // value = 0.digits * 10^n
+            const int n = k + exponent;
+
+            const int fixed_length = n >= k ? n : n > 0 ? k + 1 : 2 - n + k;
+            const int sci_exponent = n - 1;
+            const int sci_length = k + ( k > 1 ? 1 : 0 ) + 2
+                                   + ( sci_exponent >= 100 || sci_exponent <= -100 ? 3 : 2 );
+
+            if ( fixed_length <= sci_length )
+            {
+                if ( n >= k )
+                {
+                    for ( int i = 0; i < k; ++i )
+                        *out++ = digits[i];
+
+                    out = impl::fill_chars( out, n - k, '0' );
+                }
+                else if ( n > 0 )
+                {
+                    for ( int i = 0; i < k; ++i )
+                    {
+                        if ( i == n )
+                            *out++ = '.';
+
+                        *out++ = digits[i];
+                    }
+                }
+                else
+                {
+                    *out++ = '0';
+                    *out++ = '.';
+                    out = impl::fill_chars( out, -n, '0' );
+
+                    for ( int i = 0; i < k; ++i )
+                        *out++ = digits[i];
+                }
+            }
+            else
+            {
+                *out++ = digits[0];
+
+                if ( k > 1 )
+                {
+                    *out++ = '.';
+
+                    for ( int i = 1; i < k; ++i )
+                        *out++ = digits[i];
+                }
+
+                int e = sci_exponent < 0 ? -sci_exponent : sci_exponent;
+
+                *out++ = 'e';
+                *out++ = sci_exponent < 0 ? '-' : '+';
+
+                if ( e >= 100 )
+                {
+                    *out++ = static_cast<char>( '0' + e / 100 );
+                    e %= 100;
+                }
+
+                *out++ = static_cast<char>( '0' + e / 10 );
+                *out++ = static_cast<char>( '0' + e % 10 );
+            }
+        }
+
+        const auto length = out - text;
+
+        if ( last - first < length )
+            return to_chars_result<Char>{ last, errc::value_too_large };
+
+        for ( int i = 0; i < length; ++i )
+            *first++ = static_cast<Char>( text[i] );
+
+        return to_chars_result<Char>{ first, errc::ok };
+    }
+} // namespace rtl
@@ -12,15 +12,232 @@
 
 #include <rtl/int.hpp>
 #include <rtl/limits.hpp>
+#include <rtl/math.hpp>
+#include <rtl/type_traits.hpp>
+
+#include <rtl/sys/debug.hpp>
 
 namespace rtl
 {
-    template<typename Int, int FractBits>
+    namespace impl
+    {
+        // Integer type that holds a full product of two fixed point values
+        template<typename Int>
+        struct fix_wide
+        {
+        };
+
+        template<>
+        struct fix_wide<short>
+        {
+            using type = int;
+        };
+
+        template<>
+        struct fix_wide<int>
+        {
+            using type = int64_t;
+        };
+
+        template<typename Int, typename Wide>
+        struct fix_wide_or
+        {
+            using type = Wide;
+        };
+
+        template<typename Int>
+        struct fix_wide_or<Int, void> : fix_wide<Int>
+        {
+        };
+
+        template<typename Wide>
+        [[nodiscard]] constexpr uint64_t fix_magnitude( Wide value )
+        {
+            return value < 0 ? 0ull - static_cast<uint64_t>( value )
+                             : static_cast<uint64_t>( value );
+        }
+
+        // Truncating division of wide values, the divisor is always in the range of Int
+        template<typename Wide>
+        [[nodiscard]] constexpr Wide fix_divide( Wide dividend, Wide divisor, Wide& remainder )
+        {
+            if constexpr ( sizeof( Wide ) > sizeof( int ) )
+            {
+                uint32_t rest = 0;
+
+                const uint32_t magnitude = static_cast<uint32_t>( fix_magnitude( divisor ) );
+                const uint64_t quotient = udiv64_32( fix_magnitude( dividend ), magnitude, rest );
+
+                remainder = dividend < 0 ? -static_cast<Wide>( rest ) : static_cast<Wide>( rest );
+
+                return ( dividend < 0 ) != ( divisor < 0 ) ? -static_cast<Wide>( quotient )
+                                                           : static_cast<Wide>( quotient );
+            }
+            else
+            {
+                remainder = dividend % divisor;
+                return dividend / divisor;
+            }
+        }
+
+        // Integer hash, a reproducible source of rounding noise
+        [[nodiscard]] constexpr uint32_t fix_noise( uint64_t value )
+        {
+            uint32_t x = static_cast<uint32_t>( value ) ^ static_cast<uint32_t>( value >> 32 );
+
+            x ^= x >> 16;
+            x *= 0x7feb352du;
+            x ^= x >> 15;
+            x *= 0x846ca68bu;
+            x ^= x >> 16;
+
+            return x;
+        }
+    } // namespace impl
+
+    // Rounding of products and quotients, applied in the wide type
+    namespace fix_rounding
+    {
+        // Drops the fraction bits: products round down, quotients round toward zero
+        struct truncate
+        {
+            template<int Shift, typename Wide>
+            [[nodiscard]] static constexpr Wide shift( Wide value )
+            {
+                return value >> Shift;
+            }
+
+            template<typename Wide>
+            [[nodiscard]] static constexpr Wide divide( Wide dividend, Wide divisor )
+            {
+                Wide remainder = 0;
+                return impl::fix_divide( dividend, divisor, remainder );
+            }
+        };
+
+        // Rounds to nearest, ties away from zero for quotients and upward for products
+        struct nearest
+        {
+            template<int Shift, typename Wide>
+            [[nodiscard]] static constexpr Wide shift( Wide value )
+            {
+                return ( value + ( ( Wide( 1 ) << Shift ) >> 1 ) ) >> Shift;
+            }
+
+            template<typename Wide>
+            [[nodiscard]] static constexpr Wide divide( Wide dividend, Wide divisor )
+            {
+                Wide       remainder = 0;
+                const Wide quotient = impl::fix_divide( dividend, divisor, remainder );
+
+                if ( 2 * impl::fix_magnitude( remainder ) < impl::fix_magnitude( divisor ) )
+                    return quotient;
+
+                return ( dividend < 0 ) != ( divisor < 0 ) ? quotient - 1 : quotient + 1;
+            }
+        };
+
+        // Rounds up with probability equal to the dropped fraction, so that long accumulations
+        // stay unbiased. NOTE: the noise is a hash of the operands, results are reproducible.
+        struct stochastic
+        {
+            template<int Shift, typename Wide>
+            [[nodiscard]] static constexpr Wide shift( Wide value )
+            {
+                const uint32_t noise = impl::fix_noise( static_cast<uint64_t>( value ) );
+                return ( value + static_cast<Wide>( noise & ( ( 1u << Shift ) - 1 ) ) ) >> Shift;
+            }
+
+            template<typename Wide>
+            [[nodiscard]] static constexpr Wide divide( Wide dividend, Wide divisor )
+            {
+                Wide       remainder = 0;
+                const Wide quotient = impl::fix_divide( dividend, divisor, remainder );
+
+                const uint64_t noise = impl::fix_noise( static_cast<uint64_t>( dividend ) );
+                const uint64_t threshold = ( noise * impl::fix_magnitude( divisor ) ) >> 32;
+
+                if ( impl::fix_magnitude( remainder ) <= threshold )
+                    return quotient;
+
+                return ( dividend < 0 ) != ( divisor < 0 ) ? quotient - 1 : quotient + 1;
+            }
+        };
+    } // namespace fix_rounding
+
+    // Narrowing of wide results back to the value type
+    namespace fix_overflow
+    {
+        struct wrap
+        {
+            template<typename Int, typename Wide>
+            [[nodiscard]] static constexpr Int narrow( Wide value )
+            {
+                return static_cast<Int>( value );
+            }
+        };
+
+        struct saturate
+        {
+            template<typename Int, typename Wide>
+            [[nodiscard]] static constexpr Int narrow( Wide value )
+            {
+                if ( value > numeric_limits<Int>::max() )
+                    return numeric_limits<Int>::max();
+
+                if ( value < numeric_limits<Int>::min() )
+                    return numeric_limits<Int>::min();
+
+                return static_cast<Int>( value );
+            }
+        };
+
+        // Wraps around like 'wrap', but reports the overflow through RTL_ASSERT
+        // NOTE: in constant evaluation an overflow is always a compile error, whether
+        // RTL_ENABLE_ASSERT is set or not
+        struct assert
+        {
+            template<typename Int, typename Wide>
+            [[nodiscard]] static constexpr Int narrow( Wide value )
+            {
+                if ( value > numeric_limits<Int>::max() || value < numeric_limits<Int>::min() )
+                {
+                    if ( is_constant_evaluated() )
+                        overflow_in_constant_evaluation();
+
+                    RTL_ASSERT( !"fix overflow" );
+                }
+
+                return static_cast<Int>( value );
+            }
+
+        private:
+            // NOTE: not constexpr, a call ends constant evaluation with an error
+            static void overflow_in_constant_evaluation()
+            {
+            }
+        };
+    } // namespace fix_overflow
+
+    // NOTE: Wide == void selects a type twice as wide as the value type
+    template<typename Rounding = fix_rounding::truncate,
+             typename Overflow = fix_overflow::wrap,
+             typename Wide = void>
+    struct fix_policy
+    {
+        using rounding = Rounding;
+        using overflow = Overflow;
+        using wide = Wide;
+    };
+
+    template<typename Int, int FractBits, typename Policy = fix_policy<>>
     class fix final
     {
     public:
-        using type = fix<Int, FractBits>;
+        using type = fix<Int, FractBits, Policy>;
         using value_type = Int;
+        using policy_type = Policy;
+        using wide_type = typename impl::fix_wide_or<Int, typename Policy::wide>::type;
 
         static constexpr int total_bits = sizeof( value_type ) * 8;
         static constexpr int fract_bits = FractBits;
@@ -28,6 +245,7 @@ namespace rtl
 
         static_assert( int_bits + fract_bits == total_bits );
         static_assert( numeric_limits<value_type>::is_signed );
+        static_assert( sizeof( wide_type ) >= 2 * sizeof( value_type ) );
 
         fix() = default;
 
@@ -56,6 +274,16 @@ namespace rtl
                                            : ( ( 1 << fract_bits ) >> i ) );
         }
 
+        [[nodiscard]] static constexpr type from_raw( value_type value )
+        {
+            return type::from_value( value );
+        }
+
+        [[nodiscard]] constexpr value_type raw() const
+        {
+            return value;
+        }
+
         [[nodiscard]] static constexpr type min()
         {
             return type::from_value( 1 );
@@ -68,12 +296,12 @@ namespace rtl
 
         [[nodiscard]] constexpr type operator+( const type& rhs ) const
         {
-            return type::from_value( value + rhs.value );
+            return type::from_value( narrow( static_cast<wide_type>( value ) + rhs.value ) );
         }
 
         [[nodiscard]] constexpr type operator-( const type& rhs ) const
         {
-            return type::from_value( value - rhs.value );
+            return type::from_value( narrow( static_cast<wide_type>( value ) - rhs.value ) );
         }
 
         [[nodiscard]] constexpr type operator-( float rhs ) const
@@ -83,14 +311,14 @@ namespace rtl
 
         [[nodiscard]] constexpr type operator*( const type& rhs ) const
         {
-            // TODO: check overflow
-            return type::from_value( ( value * rhs.value ) >> fract_bits );
+            // NOTE: the product is rounded in the wide type, only the result may overflow
+            return type::from_value( narrow( Policy::rounding::template shift<fract_bits>(
+                static_cast<wide_type>( value ) * rhs.value ) ) );
         }
 
         [[nodiscard]] constexpr type operator*( int rhs ) const
         {
-            // TODO: check overflow
-            return type::from_value( value * rhs );
+            return type::from_value( narrow( static_cast<wide_type>( value ) * rhs ) );
         }
 
         [[nodiscard]] constexpr type operator*( float rhs ) const
@@ -100,8 +328,10 @@ namespace rtl
 
         [[nodiscard]] constexpr type operator/( const type& rhs ) const
         {
-            // TODO: check overflow
-            return type::from_value( ( value << fract_bits ) / rhs.value );
+            // NOTE: the dividend is scaled in the wide type, only the result may overflow
+            return type::from_value( narrow( Policy::rounding::divide(
+                static_cast<wide_type>( value ) * ( wide_type( 1 ) << fract_bits ),
+                static_cast<wide_type>( rhs.value ) ) ) );
         }
 
         [[nodiscard]] constexpr type operator/( int div ) const
@@ -111,26 +341,22 @@ namespace rtl
 
         [[nodiscard]] constexpr type operator-() const
         {
-            return type::from_value( -value );
+            return type::from_value( narrow( -static_cast<wide_type>( value ) ) );
         }
 
         constexpr type& operator+=( const type& rhs )
         {
-            value += rhs.value;
-            return *this;
+            return *this = *this + rhs;
         }
 
         constexpr type& operator-=( const type& rhs )
         {
-            value -= rhs.value;
-            return *this;
+            return *this = *this - rhs;
         }
 
         constexpr type& operator*=( int rhs )
         {
-            // TODO: check overflow
-            value *= rhs;
-            return *this;
+            return *this = *this * rhs;
         }
 
         constexpr type& operator/=( int rhs )
@@ -202,9 +428,14 @@ namespace rtl
     private:
         value_type value;
 
+        [[nodiscard]] static constexpr value_type narrow( wide_type wide )
+        {
+            return Policy::overflow::template narrow<value_type>( wide );
+        }
+
         static constexpr type from_value( value_type value )
         {
-            type type;
+            type type {};
             type.value = value;
             return type;
         }
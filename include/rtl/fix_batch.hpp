@@ -0,0 +1,430 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/fix.hpp>
+#include <rtl/int.hpp>
+#include <rtl/limits.hpp>
+#include <rtl/span.hpp>
+#include <rtl/type_traits.hpp>
+
+#if RTL_ENABLE_SIMD
+    #include <emmintrin.h>
+    #if defined( __SSE4_1__ ) || defined( __AVX__ )
+        #include <smmintrin.h>
+    #endif
+#endif
+
+namespace rtl
+{
+    namespace impl
+    {
+        namespace fix_batch
+        {
+            // NOTE: input spans do not take part in template argument deduction, so arrays and
+            // spans of non-const values are accepted as well
+            template<typename T>
+            using input = span<const type_identity_t<T>>;
+
+            // Kernel operations on raw values, one element at a time
+            template<typename Int, int F>
+            struct scalar
+            {
+                using wide = typename fix_wide<Int>::type;
+
+                static constexpr Int broadcast( Int a )
+                {
+                    return a;
+                }
+
+                static constexpr Int add( Int a, Int b )
+                {
+                    return static_cast<Int>( static_cast<wide>( a ) + b );
+                }
+
+                static constexpr Int add_sat( Int a, Int b )
+                {
+                    return fix_overflow::saturate::narrow<Int>( static_cast<wide>( a ) + b );
+                }
+
+                static constexpr Int sub( Int a, Int b )
+                {
+                    return static_cast<Int>( static_cast<wide>( a ) - b );
+                }
+
+                static constexpr Int mul( Int a, Int b )
+                {
+                    return static_cast<Int>( ( static_cast<wide>( a ) * b ) >> F );
+                }
+
+                static constexpr Int mul_sat( Int a, Int b )
+                {
+                    const wide product = static_cast<wide>( a ) * b;
+                    return fix_overflow::saturate::narrow<Int>( product >> F );
+                }
+
+                static constexpr Int min( Int a, Int b )
+                {
+                    return a < b ? a : b;
+                }
+
+                static constexpr Int max( Int a, Int b )
+                {
+                    return a < b ? b : a;
+                }
+            };
+
+#if RTL_ENABLE_SIMD
+            // Kernel operations on raw values, one SSE2 register at a time
+            template<typename Int, int F>
+            struct vector;
+
+            template<int F>
+            struct vector<int, F>
+            {
+                static __m128i broadcast( int a )
+                {
+                    return _mm_set1_epi32( a );
+                }
+
+                static __m128i select( __m128i mask, __m128i a, __m128i b )
+                {
+                    return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+                }
+
+                static __m128i add( __m128i a, __m128i b )
+                {
+                    return _mm_add_epi32( a, b );
+                }
+
+                static __m128i add_sat( __m128i a, __m128i b )
+                {
+                    const __m128i sum = _mm_add_epi32( a, b );
+
+                    // Overflow if the sign of the sum differs from the signs of both operands
+                    const __m128i overflow = _mm_srai_epi32(
+                        _mm_and_si128( _mm_xor_si128( a, sum ), _mm_xor_si128( b, sum ) ), 31 );
+                    const __m128i limit
+                        = _mm_xor_si128( _mm_srai_epi32( a, 31 ), _mm_set1_epi32( 0x7fffffff ) );
+
+                    return select( overflow, limit, sum );
+                }
+
+                static __m128i sub( __m128i a, __m128i b )
+                {
+                    return _mm_sub_epi32( a, b );
+                }
+
+                // 'result' receives the lower, 'high' the upper 32 bits of (a * b) >> F and a * b
+                static void multiply( __m128i a, __m128i b, __m128i& result, __m128i& high )
+                {
+                    const __m128i a_odd = _mm_srli_epi64( a, 32 );
+                    const __m128i b_odd = _mm_srli_epi64( b, 32 );
+
+    #if defined( __SSE4_1__ ) || defined( __AVX__ )
+                    const __m128i even = _mm_mul_epi32( a, b );
+                    const __m128i odd = _mm_mul_epi32( a_odd, b_odd );
+    #else
+                    // Signed upper halves from unsigned products: subtract b if a < 0, a if b < 0
+                    const __m128i correction
+                        = _mm_add_epi32( _mm_and_si128( _mm_srai_epi32( a, 31 ), b ),
+                                         _mm_and_si128( _mm_srai_epi32( b, 31 ), a ) );
+
+                    const __m128i even = _mm_sub_epi64( _mm_mul_epu32( a, b ),
+                                                        _mm_slli_epi64( correction, 32 ) );
+                    const __m128i odd = _mm_sub_epi64(
+                        _mm_mul_epu32( a_odd, b_odd ),
+                        _mm_and_si128( correction, _mm_set_epi32( -1, 0, -1, 0 ) ) );
+    #endif
+                    // NOTE: the logical shift is fine, only the lower 32 bits are kept
+                    result = _mm_unpacklo_epi32(
+                        _mm_shuffle_epi32( _mm_srli_epi64( even, F ), _MM_SHUFFLE( 3, 1, 2, 0 ) ),
+                        _mm_shuffle_epi32( _mm_srli_epi64( odd, F ), _MM_SHUFFLE( 3, 1, 2, 0 ) ) );
+
+                    high = _mm_unpacklo_epi32(
+                        _mm_shuffle_epi32( even, _MM_SHUFFLE( 2, 0, 3, 1 ) ),
+                        _mm_shuffle_epi32( odd, _MM_SHUFFLE( 2, 0, 3, 1 ) ) );
+                }
+
+                static __m128i mul( __m128i a, __m128i b )
+                {
+                    __m128i result, high;
+                    multiply( a, b, result, high );
+
+                    return result;
+                }
+
+                static __m128i mul_sat( __m128i a, __m128i b )
+                {
+                    __m128i result, high;
+                    multiply( a, b, result, high );
+
+                    // The result fits if bits 31 + F .. 63 of the product are all equal
+                    __m128i top = high;
+                    if constexpr ( F > 0 )
+                        top = _mm_srai_epi32( high, F - 1 );
+
+                    const __m128i fits = _mm_cmpeq_epi32( top, _mm_srai_epi32( result, 31 ) );
+                    const __m128i limit
+                        = _mm_xor_si128( _mm_srai_epi32( high, 31 ), _mm_set1_epi32( 0x7fffffff ) );
+
+                    return select( fits, result, limit );
+                }
+
+                static __m128i min( __m128i a, __m128i b )
+                {
+    #if defined( __SSE4_1__ ) || defined( __AVX__ )
+                    return _mm_min_epi32( a, b );
+    #else
+                    return select( _mm_cmpgt_epi32( a, b ), b, a );
+    #endif
+                }
+
+                static __m128i max( __m128i a, __m128i b )
+                {
+    #if defined( __SSE4_1__ ) || defined( __AVX__ )
+                    return _mm_max_epi32( a, b );
+    #else
+                    return select( _mm_cmpgt_epi32( a, b ), a, b );
+    #endif
+                }
+            };
+
+            template<int F>
+            struct vector<short, F>
+            {
+                static __m128i broadcast( short a )
+                {
+                    return _mm_set1_epi16( a );
+                }
+
+                static __m128i add( __m128i a, __m128i b )
+                {
+                    return _mm_add_epi16( a, b );
+                }
+
+                static __m128i add_sat( __m128i a, __m128i b )
+                {
+                    return _mm_adds_epi16( a, b );
+                }
+
+                static __m128i sub( __m128i a, __m128i b )
+                {
+                    return _mm_sub_epi16( a, b );
+                }
+
+                // Full 32-bit products of the lower and upper four lanes, shifted right by F
+                static void multiply( __m128i a, __m128i b, __m128i& lo, __m128i& hi )
+                {
+                    const __m128i low = _mm_mullo_epi16( a, b );
+                    const __m128i high = _mm_mulhi_epi16( a, b );
+
+                    lo = _mm_srai_epi32( _mm_unpacklo_epi16( low, high ), F );
+                    hi = _mm_srai_epi32( _mm_unpackhi_epi16( low, high ), F );
+                }
+
+                static __m128i mul( __m128i a, __m128i b )
+                {
+                    __m128i lo, hi;
+                    multiply( a, b, lo, hi );
+
+                    // Sign extension of the lower 16 bits makes the packing lossless
+                    return _mm_packs_epi32( _mm_srai_epi32( _mm_slli_epi32( lo, 16 ), 16 ),
+                                            _mm_srai_epi32( _mm_slli_epi32( hi, 16 ), 16 ) );
+                }
+
+                static __m128i mul_sat( __m128i a, __m128i b )
+                {
+                    __m128i lo, hi;
+                    multiply( a, b, lo, hi );
+
+                    return _mm_packs_epi32( lo, hi );
+                }
+
+                static __m128i min( __m128i a, __m128i b )
+                {
+                    return _mm_min_epi16( a, b );
+                }
+
+                static __m128i max( __m128i a, __m128i b )
+                {
+                    return _mm_max_epi16( a, b );
+                }
+            };
+
+            template<typename T>
+            [[nodiscard]] inline __m128i load( const T* p )
+            {
+                return _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+            }
+#endif
+
+            // Applies the kernel to 'size' elements of the inputs
+            template<typename Int, int F, typename P, typename Kernel, typename... Inputs>
+            void apply( fix<Int, F, P>* out, size_t size, Kernel kernel, const Inputs*... inputs )
+            {
+                static_assert( ( is_same_v<Inputs, fix<Int, F, P>> && ... ) );
+
+                size_t i = 0;
+
+#if RTL_ENABLE_SIMD
+                constexpr size_t lanes = 16 / sizeof( Int );
+
+                for ( ; i + lanes <= size; i += lanes )
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( out + i ),
+                                      kernel( vector<Int, F>(), load( inputs + i )... ) );
+#endif
+
+                for ( ; i < size; ++i )
+                    out[i] = fix<Int, F, P>::from_raw(
+                        kernel( scalar<Int, F>(), inputs[i].raw()... ) );
+            }
+        } // namespace fix_batch
+    }     // namespace impl
+
+    // Element-wise operations over arrays of fixed point values. Each one processes out.size()
+    // elements, the inputs must be at least that long. Plain variants wrap around on overflow,
+    // *_sat variants saturate; all of them truncate whatever the rounding policy of fix is.
+    namespace batch
+    {
+        template<typename Int, int F, typename P>
+        void add( impl::fix_batch::input<fix<Int, F, P>> a,
+                  impl::fix_batch::input<fix<Int, F, P>> b,
+                  span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                []( auto ops, auto x, auto y ) { return ops.add( x, y ); },
+                a.data(),
+                b.data() );
+        }
+
+        template<typename Int, int F, typename P>
+        void add_sat( impl::fix_batch::input<fix<Int, F, P>> a,
+                      impl::fix_batch::input<fix<Int, F, P>> b,
+                      span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                []( auto ops, auto x, auto y ) { return ops.add_sat( x, y ); },
+                a.data(),
+                b.data() );
+        }
+
+        template<typename Int, int F, typename P>
+        void mul( impl::fix_batch::input<fix<Int, F, P>> a,
+                  impl::fix_batch::input<fix<Int, F, P>> b,
+                  span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                []( auto ops, auto x, auto y ) { return ops.mul( x, y ); },
+                a.data(),
+                b.data() );
+        }
+
+        template<typename Int, int F, typename P>
+        void mul_sat( impl::fix_batch::input<fix<Int, F, P>> a,
+                      impl::fix_batch::input<fix<Int, F, P>> b,
+                      span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                []( auto ops, auto x, auto y ) { return ops.mul_sat( x, y ); },
+                a.data(),
+                b.data() );
+        }
+
+        // out = a * b + c
+        template<typename Int, int F, typename P>
+        void mul_add( impl::fix_batch::input<fix<Int, F, P>> a,
+                      impl::fix_batch::input<fix<Int, F, P>> b,
+                      impl::fix_batch::input<fix<Int, F, P>> c,
+                      span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                []( auto ops, auto x, auto y, auto z ) { return ops.add( ops.mul( x, y ), z ); },
+                a.data(),
+                b.data(),
+                c.data() );
+        }
+
+        // out = a * b + c, saturating after each step
+        template<typename Int, int F, typename P>
+        void mul_add_sat( impl::fix_batch::input<fix<Int, F, P>> a,
+                          impl::fix_batch::input<fix<Int, F, P>> b,
+                          impl::fix_batch::input<fix<Int, F, P>> c,
+                          span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                []( auto ops, auto x, auto y, auto z )
+                { return ops.add_sat( ops.mul_sat( x, y ), z ); },
+                a.data(),
+                b.data(),
+                c.data() );
+        }
+
+        // out = a + ( b - a ) * t
+        template<typename Int, int F, typename P>
+        void lerp( impl::fix_batch::input<fix<Int, F, P>> a,
+                   impl::fix_batch::input<fix<Int, F, P>> b,
+                   impl::fix_batch::input<fix<Int, F, P>> t,
+                   span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                []( auto ops, auto x, auto y, auto z )
+                { return ops.add( x, ops.mul( ops.sub( y, x ), z ) ); },
+                a.data(),
+                b.data(),
+                t.data() );
+        }
+
+        // out = a + ( b - a ) * t, with the same t for all elements
+        template<typename Int, int F, typename P>
+        void lerp( impl::fix_batch::input<fix<Int, F, P>> a,
+                   impl::fix_batch::input<fix<Int, F, P>> b,
+                   type_identity_t<fix<Int, F, P>>        t,
+                   span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                [t = t.raw()]( auto ops, auto x, auto y )
+                { return ops.add( x, ops.mul( ops.sub( y, x ), ops.broadcast( t ) ) ); },
+                a.data(),
+                b.data() );
+        }
+
+        template<typename Int, int F, typename P>
+        void clamp( impl::fix_batch::input<fix<Int, F, P>> a,
+                    type_identity_t<fix<Int, F, P>>        min,
+                    type_identity_t<fix<Int, F, P>>        max,
+                    span<fix<Int, F, P>>                   out )
+        {
+            impl::fix_batch::apply(
+                out.data(),
+                out.size(),
+                [min = min.raw(), max = max.raw()]( auto ops, auto x )
+                { return ops.min( ops.max( x, ops.broadcast( min ) ), ops.broadcast( max ) ); },
+                a.data() );
+        }
+    } // namespace batch
+} // namespace rtl
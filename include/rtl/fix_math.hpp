@@ -0,0 +1,416 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/array.hpp>
+#include <rtl/bit.hpp>
+#include <rtl/fix.hpp>
+#include <rtl/int.hpp>
+#include <rtl/limits.hpp>
+#include <rtl/math.hpp>
+
+namespace rtl
+{
+    namespace impl
+    {
+        namespace fix_math
+        {
+            // Compile-time double math, used only to generate the lookup tables
+            namespace generator
+            {
+                inline constexpr double pi = 3.14159265358979323846;
+                inline constexpr double ln2 = 0.69314718055994530942;
+
+                // NOTE: x in [0, pi/2]
+                [[nodiscard]] constexpr double sin( double x )
+                {
+                    double term = x;
+                    double sum = x;
+
+                    for ( int n = 1; n < 16; ++n )
+                    {
+                        term *= -x * x / ( ( 2 * n ) * ( 2 * n + 1 ) );
+                        sum += term;
+                    }
+
+                    return sum;
+                }
+
+                // NOTE: x in [0, 2]
+                [[nodiscard]] constexpr double atan( double x )
+                {
+                    double bias = 0;
+
+                    // atan(x) = pi/4 + atan((x-1)/(x+1)) keeps the series argument below 0.42
+                    if ( x > 0.41421356 )
+                    {
+                        bias = pi / 4;
+                        x = ( x - 1 ) / ( x + 1 );
+                    }
+
+                    double power = x;
+                    double sum = x;
+
+                    for ( int n = 1; n < 24; ++n )
+                    {
+                        power *= -x * x;
+                        sum += power / ( 2 * n + 1 );
+                    }
+
+                    return bias + sum;
+                }
+
+                // NOTE: x in [0, 2]
+                [[nodiscard]] constexpr double exp2( double x )
+                {
+                    const double y = x * ln2;
+
+                    double term = 1;
+                    double sum = 1;
+
+                    for ( int n = 1; n < 24; ++n )
+                    {
+                        term *= y / n;
+                        sum += term;
+                    }
+
+                    return sum;
+                }
+
+                // NOTE: x in [1, 3]
+                [[nodiscard]] constexpr double log2( double x )
+                {
+                    // ln(x) = 2 * atanh((x-1)/(x+1))
+                    const double z = ( x - 1 ) / ( x + 1 );
+
+                    double power = z;
+                    double sum = z;
+
+                    for ( int n = 1; n < 24; ++n )
+                    {
+                        power *= z * z;
+                        sum += power / ( 2 * n + 1 );
+                    }
+
+                    return 2 * sum / ln2;
+                }
+
+                template<typename T>
+                [[nodiscard]] constexpr T round( double x, int fract_bits )
+                {
+                    const double scaled = x * static_cast<double>( 1ull << fract_bits );
+                    return static_cast<T>( scaled < 0 ? scaled - 0.5 : scaled + 0.5 );
+                }
+            } // namespace generator
+
+            inline constexpr int table_bits = 8;
+
+            // NOTE: one guard entry past 1.0, so that interpolation never reads out of bounds
+            inline constexpr unsigned table_size = ( 1u << table_bits ) + 2;
+
+            template<typename Int, int FractBits, typename Function>
+            [[nodiscard]] constexpr array<Int, table_size> make_table( Function function )
+            {
+                array<Int, table_size> table {};
+
+                for ( unsigned i = 0; i < table_size; ++i )
+                {
+                    const double x = static_cast<double>( i ) / ( 1 << table_bits );
+                    table[i] = generator::round<Int>( function( x ), FractBits );
+                }
+
+                return table;
+            }
+
+            // Function values sampled on [0, 1] in the format of fix<Int, FractBits>
+            template<typename Int, int FractBits>
+            struct tables
+            {
+                static_assert( FractBits >= table_bits,
+                               "rtl::fix_math needs at least 8 fraction bits" );
+
+                // NOTE: exp2 reaches 2 and pi is above 3
+                static_assert( static_cast<int>( sizeof( Int ) * 8 ) - 1 - FractBits >= 2,
+                               "rtl::fix_math needs at least 2 integer bits besides the sign" );
+
+                static constexpr auto sin = make_table<Int, FractBits>(
+                    []( double x ) { return generator::sin( x * generator::pi / 2 ); } );
+
+                static constexpr auto atan = make_table<Int, FractBits>(
+                    []( double x ) { return generator::atan( x ); } );
+
+                static constexpr auto exp2 = make_table<Int, FractBits>(
+                    []( double x ) { return generator::exp2( x ); } );
+
+                static constexpr auto log2 = make_table<Int, FractBits>(
+                    []( double x ) { return generator::log2( 1 + x ); } );
+
+                static constexpr Int half_pi
+                    = generator::round<Int>( generator::pi / 2, FractBits );
+
+                static constexpr Int pi = generator::round<Int>( generator::pi, FractBits );
+            };
+
+            // 2/pi in Q30, converts radians to quarter turns
+            inline constexpr int64_t quarter_turns
+                = generator::round<int64_t>( 2 / generator::pi, 30 );
+
+            // NOTE: if x == 0, then result is undefined
+            [[nodiscard]] constexpr int floor_log2( uint32_t x )
+            {
+                return bit_width( x ) - 1;
+            }
+
+            template<typename Int>
+            [[nodiscard]] constexpr uint32_t magnitude( Int value )
+            {
+                return value < 0 ? 0u - static_cast<uint32_t>( value )
+                                 : static_cast<uint32_t>( value );
+            }
+
+            // Linear interpolation between table entries, index is in [0, 1] with IndexBits
+            template<int IndexBits, typename Int>
+            [[nodiscard]] constexpr Int interpolate( const array<Int, table_size>& table,
+                                                     uint32_t                      index )
+            {
+                using wide = typename fix_wide<Int>::type;
+
+                constexpr int shift = IndexBits - table_bits;
+                static_assert( shift >= 0 );
+
+                const uint32_t i = index >> shift;
+                const wide     rem = static_cast<wide>( index & ( ( 1u << shift ) - 1 ) );
+                const wide     delta = static_cast<wide>( table[i + 1] - table[i] );
+
+                return static_cast<Int>(
+                    table[i] + ( ( delta * rem + ( ( wide( 1 ) << shift ) >> 1 ) ) >> shift ) );
+            }
+
+            // Rounded right shift, shift in [1, 31]
+            [[nodiscard]] constexpr uint32_t shift_right( uint32_t value, int shift )
+            {
+                return static_cast<uint32_t>(
+                    ( static_cast<uint64_t>( value ) + ( 1u << ( shift - 1 ) ) ) >> shift );
+            }
+
+            // Newton-Raphson reciprocal of a mantissa in [0.5, 1) as Q32, result in [1, 2] as Q30
+            [[nodiscard]] constexpr uint32_t reciprocal( uint32_t m )
+            {
+                // NOTE: 48/17 - 32/17 * m is the minimax linear estimate, three steps reach Q30
+                uint32_t y = 3031741621u - static_cast<uint32_t>( ( 2021161081ull * m ) >> 32 );
+
+                for ( int i = 0; i < 3; ++i )
+                {
+                    const uint32_t e
+                        = static_cast<uint32_t>( ( static_cast<uint64_t>( m ) * y ) >> 32 );
+
+                    y = static_cast<uint32_t>(
+                        ( static_cast<uint64_t>( y ) * ( 0x80000000u - e ) ) >> 30 );
+                }
+
+                return y;
+            }
+
+            // Integer square root of a 64-bit value, rounded to nearest
+            [[nodiscard]] constexpr uint32_t sqrt( uint64_t value )
+            {
+                uint64_t bit = 1ull << 62;
+                while ( bit > value )
+                    bit >>= 2;
+
+                uint64_t root = 0;
+
+                while ( bit )
+                {
+                    if ( value >= root + bit )
+                    {
+                        value -= root + bit;
+                        root = ( root >> 1 ) + bit;
+                    }
+                    else
+                    {
+                        root >>= 1;
+                    }
+
+                    bit >>= 2;
+                }
+
+                // NOTE: remainder > root means value > (root + 1/2)^2
+                return static_cast<uint32_t>( value > root ? root + 1 : root );
+            }
+
+            // NOTE: turns are quarter turns in Q30
+            template<typename Int, int FractBits>
+            [[nodiscard]] constexpr Int sin_quarter_turns( int64_t turns )
+            {
+                constexpr uint32_t one = 1u << 30;
+
+                const int      quadrant = static_cast<int>( turns >> 30 ) & 3;
+                const uint32_t fraction = static_cast<uint32_t>( turns ) & ( one - 1 );
+
+                const Int value = interpolate<30>( tables<Int, FractBits>::sin,
+                                                   quadrant & 1 ? one - fraction : fraction );
+
+                return quadrant & 2 ? static_cast<Int>( -value ) : value;
+            }
+        } // namespace fix_math
+    } // namespace impl
+
+    // Deterministic elementary functions on fixed point values, integer arithmetic only.
+    // Supported formats have 8 to (bits of Int - 3) fraction bits, e.g. fix<int, 8..29> and
+    // fix<short, 8..13>.
+    namespace fix_math
+    {
+        // NOTE: 1/0 saturates to max()
+        template<typename Int, int F, typename P>
+        [[nodiscard]] constexpr fix<Int, F, P> reciprocal( fix<Int, F, P> x )
+        {
+            using type = fix<Int, F, P>;
+
+            const Int value = x.raw();
+            if ( value == 0 )
+                return type::max();
+
+            const uint32_t magnitude = impl::fix_math::magnitude( value );
+            const int      log2 = impl::fix_math::floor_log2( magnitude );
+
+            const uint32_t y = impl::fix_math::reciprocal( magnitude << ( 31 - log2 ) );
+
+            const int shift = 31 + log2 - 2 * F;
+
+            uint32_t result = 0;
+            if ( shift < 0 )
+                return value < 0 ? type::from_raw( numeric_limits<Int>::min() ) : type::max();
+            else if ( shift == 0 )
+                result = y;
+            else if ( shift < 32 )
+                result = impl::fix_math::shift_right( y, shift );
+            else
+                result = 0;
+
+            if ( result > static_cast<uint32_t>( numeric_limits<Int>::max() ) )
+                return value < 0 ? type::from_raw( numeric_limits<Int>::min() ) : type::max();
+
+            const Int raw = static_cast<Int>( result );
+            return type::from_raw( value < 0 ? static_cast<Int>( -raw ) : raw );
+        }
+
+        // NOTE: negative values give 0
+        template<typename Int, int F, typename P>
+        [[nodiscard]] constexpr fix<Int, F, P> sqrt( fix<Int, F, P> x )
+        {
+            if ( x.raw() <= 0 )
+                return fix<Int, F, P>::from_raw( 0 );
+
+            return fix<Int, F, P>::from_raw( static_cast<Int>(
+                impl::fix_math::sqrt( static_cast<uint64_t>( x.raw() ) << F ) ) );
+        }
+
+        // NOTE: x is in radians
+        template<typename Int, int F, typename P>
+        [[nodiscard]] constexpr fix<Int, F, P> sin( fix<Int, F, P> x )
+        {
+            const int64_t turns = ( x.raw() * impl::fix_math::quarter_turns ) >> F;
+            return fix<Int, F, P>::from_raw( impl::fix_math::sin_quarter_turns<Int, F>( turns ) );
+        }
+
+        // NOTE: x is in radians
+        template<typename Int, int F, typename P>
+        [[nodiscard]] constexpr fix<Int, F, P> cos( fix<Int, F, P> x )
+        {
+            const int64_t turns = ( x.raw() * impl::fix_math::quarter_turns ) >> F;
+            return fix<Int, F, P>::from_raw(
+                impl::fix_math::sin_quarter_turns<Int, F>( turns + ( 1 << 30 ) ) );
+        }
+
+        // NOTE: result is in [-pi, pi], atan2(0, 0) == 0
+        template<typename Int, int F, typename P>
+        [[nodiscard]] constexpr fix<Int, F, P> atan2( fix<Int, F, P> y, fix<Int, F, P> x )
+        {
+            using tables = impl::fix_math::tables<Int, F>;
+
+            const uint32_t ay = impl::fix_math::magnitude( y.raw() );
+            const uint32_t ax = impl::fix_math::magnitude( x.raw() );
+
+            if ( ay == 0 && ax == 0 )
+                return fix<Int, F, P>::from_raw( 0 );
+
+            const bool steep = ay > ax;
+
+            const uint32_t num = steep ? ax : ay;
+            const uint32_t den = steep ? ay : ax;
+
+            // NOTE: num <= den, so both fit Q32 after normalizing den to [0.5, 1)
+            const int      shift = 31 - impl::fix_math::floor_log2( den );
+            const uint32_t ratio = static_cast<uint32_t>(
+                ( static_cast<uint64_t>( num << shift )
+                  * impl::fix_math::reciprocal( den << shift ) )
+                >> 32 );
+
+            Int angle = impl::fix_math::interpolate<30>( tables::atan, ratio );
+
+            if ( steep )
+                angle = static_cast<Int>( tables::half_pi - angle );
+
+            if ( x.raw() < 0 )
+                angle = static_cast<Int>( tables::pi - angle );
+
+            return fix<Int, F, P>::from_raw( y.raw() < 0 ? static_cast<Int>( -angle ) : angle );
+        }
+
+        // NOTE: overflow saturates to max()
+        template<typename Int, int F, typename P>
+        [[nodiscard]] constexpr fix<Int, F, P> exp2( fix<Int, F, P> x )
+        {
+            using type = fix<Int, F, P>;
+
+            const int      exponent = x.raw() >> F;
+            const uint32_t fraction = static_cast<uint32_t>( x.raw() ) & ( ( 1u << F ) - 1 );
+
+            // NOTE: 2^fraction is in [1, 2)
+            const uint32_t mantissa = static_cast<uint32_t>(
+                impl::fix_math::interpolate<F>( impl::fix_math::tables<Int, F>::exp2, fraction ) );
+
+            if ( exponent > type::int_bits - 2 )
+                return type::max();
+
+            if ( exponent >= 0 )
+                return type::from_raw( static_cast<Int>( mantissa << exponent ) );
+
+            if ( exponent < -31 )
+                return type::from_raw( 0 );
+
+            return type::from_raw(
+                static_cast<Int>( impl::fix_math::shift_right( mantissa, -exponent ) ) );
+        }
+
+        // NOTE: non-positive values give the lowest representable value
+        template<typename Int, int F, typename P>
+        [[nodiscard]] constexpr fix<Int, F, P> log2( fix<Int, F, P> x )
+        {
+            using type = fix<Int, F, P>;
+
+            if ( x.raw() <= 0 )
+                return type::from_raw( numeric_limits<Int>::min() );
+
+            const uint32_t value = static_cast<uint32_t>( x.raw() );
+            const int      exponent = impl::fix_math::floor_log2( value );
+
+            // NOTE: mantissa is in [1, 2) as Q30
+            const uint32_t mantissa = value << ( 30 - exponent );
+
+            const Int fraction = impl::fix_math::interpolate<30>(
+                impl::fix_math::tables<Int, F>::log2, mantissa - ( 1u << 30 ) );
+
+            return type::from_raw( static_cast<Int>( ( exponent - F ) * ( 1 << F ) + fraction ) );
+        }
+    } // namespace fix_math
+} // namespace rtl
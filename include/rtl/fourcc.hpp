@@ -12,18 +12,19 @@
 
 #include <rtl/int.hpp>
 
-#ifndef _MSC_VER
-    #error Only MSVC compiler is supported
-#endif
-
-#ifndef _M_IX86
-    #error Unsupported CPU architecture
-#endif
-
 namespace rtl
 {
+    // Code of four characters as they are stored in a file, the first one in the lowest byte
     [[nodiscard]] constexpr uint32_t make_fourcc( uint8_t a, uint8_t b, uint8_t c, uint8_t d )
     {
-        return static_cast<uint32_t>( ( d << 24u ) | ( c << 16u ) | ( b << 8u ) | a );
+        // NOTE: uint8_t promotes to int, shifting a high bit into its sign would be undefined
+        return ( static_cast<uint32_t>( d ) << 24u ) | ( static_cast<uint32_t>( c ) << 16u )
+               | ( static_cast<uint32_t>( b ) << 8u ) | a;
+    }
+
+    // Reads a code stored in a file, e.g. a RIFF chunk identifier
+    [[nodiscard]] constexpr uint32_t load_fourcc( const uint8_t* p )
+    {
+        return make_fourcc( p[0], p[1], p[2], p[3] );
     }
 } // namespace rtl
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/algorithm.hpp>
+#include <rtl/int.hpp>
+#include <rtl/math.hpp>
+#include <rtl/string.hpp>
+#include <rtl/type_traits.hpp>
+
+namespace rtl
+{
+    namespace impl
+    {
+        // wyhash (final 4) by Wang Yi, public domain: https://github.com/wangyi-fudan/wyhash
+        namespace wyhash
+        {
+            constexpr uint64_t secret[4] = { 0x2d358dccaa6c78a5ull,
+                                             0x8bb84b93962eacc9ull,
+                                             0x4b33a62ed433d4a3ull,
+                                             0x4d5a2da51de1aa47ull };
+
+            constexpr void mum( uint64_t& a, uint64_t& b )
+            {
+                uint64_t high = 0;
+
+                a = rtl::umul128( a, b, high );
+                b = high;
+            }
+
+            [[nodiscard]] constexpr uint64_t mix( uint64_t a, uint64_t b )
+            {
+                mum( a, b );
+                return a ^ b;
+            }
+
+            // Byte at 'offset' of the little-endian representation of an element array
+            template<typename T>
+            [[nodiscard]] constexpr uint64_t read_byte( const T* p, size_t offset )
+            {
+                if constexpr ( is_integral_v<T> )
+                {
+                    if ( rtl::is_constant_evaluated() )
+                        return ( static_cast<uint64_t>( p[offset / sizeof( T )] )
+                                 >> ( 8 * ( offset % sizeof( T ) ) ) )
+                               & 0xff;
+                }
+
+                return reinterpret_cast<const uint8_t*>( p )[offset];
+            }
+
+            template<size_t Bytes, typename T>
+            [[nodiscard]] constexpr uint64_t read( const T* p, size_t offset )
+            {
+                uint64_t value = 0;
+
+                if ( rtl::is_constant_evaluated() )
+                {
+                    for ( size_t i = 0; i < Bytes; ++i )
+                        value |= read_byte( p, offset + i ) << ( 8 * i );
+                }
+                else
+                {
+                    copy_bytes( &value, reinterpret_cast<const uint8_t*>( p ) + offset, Bytes );
+                }
+
+                return value;
+            }
+
+            template<typename T>
+            [[nodiscard]] constexpr uint64_t hash( const T* p, size_t size, uint64_t seed )
+            {
+                seed ^= mix( seed ^ secret[0], secret[1] );
+
+                uint64_t a = 0;
+                uint64_t b = 0;
+
+                if ( size <= 16 )
+                {
+                    if ( size >= 4 )
+                    {
+                        const size_t shift = ( size >> 3 ) << 2;
+
+                        a = ( read<4>( p, 0 ) << 32 ) | read<4>( p, shift );
+                        b = ( read<4>( p, size - 4 ) << 32 ) | read<4>( p, size - 4 - shift );
+                    }
+                    else if ( size > 0 )
+                    {
+                        a = ( read_byte( p, 0 ) << 16 ) | ( read_byte( p, size >> 1 ) << 8 )
+                            | read_byte( p, size - 1 );
+                    }
+                }
+                else
+                {
+                    size_t offset = 0;
+                    size_t left = size;
+
+                    if ( left >= 48 )
+                    {
+                        // NOTE: three independent multiplication chains
+                        uint64_t seed1 = seed;
+                        uint64_t seed2 = seed;
+
+                        do
+                        {
+                            seed = mix( read<8>( p, offset ) ^ secret[1],
+                                        read<8>( p, offset + 8 ) ^ seed );
+                            seed1 = mix( read<8>( p, offset + 16 ) ^ secret[2],
+                                         read<8>( p, offset + 24 ) ^ seed1 );
+                            seed2 = mix( read<8>( p, offset + 32 ) ^ secret[3],
+                                         read<8>( p, offset + 40 ) ^ seed2 );
+
+                            offset += 48;
+                            left -= 48;
+                        } while ( left >= 48 );
+
+                        seed ^= seed1 ^ seed2;
+                    }
+
+                    for ( ; left > 16; left -= 16, offset += 16 )
+                        seed = mix( read<8>( p, offset ) ^ secret[1],
+                                    read<8>( p, offset + 8 ) ^ seed );
+
+                    a = read<8>( p, offset + left - 16 );
+                    b = read<8>( p, offset + left - 8 );
+                }
+
+                a ^= secret[1];
+                b ^= seed;
+                mum( a, b );
+
+                return mix( a ^ secret[0] ^ size, b ^ secret[1] );
+            }
+
+            [[nodiscard]] constexpr size_t fold( uint64_t value )
+            {
+                return static_cast<size_t>( value ^ ( value >> 32 ) );
+            }
+        } // namespace wyhash
+    }     // namespace impl
+
+    // 64-bit hash of 'count' elements, taken as their little-endian byte representation
+    template<typename T>
+    [[nodiscard]] constexpr uint64_t hash_bytes( const T* data, size_t count, uint64_t seed = 0 )
+    {
+        static_assert( is_trivially_copyable_v<T> );
+
+        return impl::wyhash::hash( data, count * sizeof( T ), seed );
+    }
+
+    [[nodiscard]] inline uint64_t hash_bytes( const void* data, size_t size, uint64_t seed = 0 )
+    {
+        return impl::wyhash::hash( static_cast<const uint8_t*>( data ), size, seed );
+    }
+
+    // 64-bit hash of a single integer
+    [[nodiscard]] constexpr uint64_t hash_mix( uint64_t value, uint64_t seed = 0 )
+    {
+        uint64_t a = value ^ impl::wyhash::secret[0];
+        uint64_t b = seed ^ impl::wyhash::secret[1];
+
+        impl::wyhash::mum( a, b );
+
+        return impl::wyhash::mix( a ^ impl::wyhash::secret[0], b ^ impl::wyhash::secret[1] );
+    }
+
+    template<typename T>
+    struct hash
+    {
+        static_assert( is_integral_v<T>, "rtl::hash is not defined for this type" );
+
+        [[nodiscard]] constexpr size_t operator()( T value ) const
+        {
+            return impl::wyhash::fold( hash_mix( static_cast<uint64_t>( value ) ) );
+        }
+    };
+
+    template<typename T>
+    struct hash<T*>
+    {
+        [[nodiscard]] size_t operator()( T* value ) const
+        {
+            return impl::wyhash::fold( hash_mix( reinterpret_cast<uintptr_t>( value ) ) );
+        }
+    };
+
+    template<typename T>
+    struct hash<basic_string_view<T>>
+    {
+        [[nodiscard]] constexpr size_t operator()( const basic_string_view<T>& value ) const
+        {
+            return impl::wyhash::fold( hash_bytes( value.data(), value.size() ) );
+        }
+    };
+
+    template<typename T>
+    struct hash<basic_string<T>>
+    {
+        [[nodiscard]] size_t operator()( const basic_string<T>& value ) const
+        {
+            return hash<basic_string_view<T>>()( value );
+        }
+    };
+} // namespace rtl
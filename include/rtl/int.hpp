@@ -27,10 +27,19 @@ namespace rtl
     typedef unsigned char      uint8_t;
     typedef char               int8_t;
 
+#if defined( __UINTPTR_TYPE__ )
+    typedef __UINTPTR_TYPE__ uintptr_t;
+#elif defined( _WIN64 )
+    typedef unsigned long long uintptr_t;
+#else
+    typedef unsigned int uintptr_t;
+#endif
+
     static_assert( sizeof( uintmax_t ) == 8 );
     static_assert( sizeof( uint64_t ) == 8 );
     static_assert( sizeof( uint32_t ) == 4 );
     static_assert( sizeof( uint16_t ) == 2 );
     static_assert( sizeof( uint8_t ) == 1 );
     static_assert( sizeof( size_t ) == sizeof( ptrdiff_t ) );
+    static_assert( sizeof( uintptr_t ) == sizeof( void* ) );
 } // namespace rtl
@@ -18,6 +18,22 @@ namespace rtl
     };
 
     // TODO: add more specializations
+    template<>
+    struct numeric_limits<short>
+    {
+        static constexpr short min()
+        {
+            return -32767 - 1;
+        }
+
+        static constexpr short max()
+        {
+            return 32767;
+        }
+
+        static constexpr bool is_signed = true;
+    };
+
     template<>
     struct numeric_limits<int>
     {
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/algorithm.hpp>
+#include <rtl/int.hpp>
+#include <rtl/span.hpp>
+
+// Decoder of the LZ4 block format, without the frame around it:
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+// Blocks are produced by the rtl_lz4 tool.
+
+namespace rtl
+{
+    namespace impl
+    {
+        namespace lz4
+        {
+            constexpr uint32_t min_match = 4;
+
+            // Bytes that a fast copy may write past the requested end
+            constexpr size_t copy_slack = 8;
+
+            // Adds the extension bytes of a 15 length nibble, returns false on truncated input
+            [[nodiscard]] inline bool read_length( const uint8_t*& src,
+                                                   const uint8_t*  src_end,
+                                                   size_t&         length )
+            {
+                uint8_t byte;
+
+                do
+                {
+                    if ( src == src_end )
+                        return false;
+
+                    byte = *src++;
+                    length += byte;
+
+                    // NOTE: a length this large can not fit anyway, stops size_t from wrapping
+                    if ( length > ( static_cast<size_t>( -1 ) >> 1 ) )
+                        return false;
+                } while ( byte == 255 );
+
+                return true;
+            }
+
+            // Copies 8 bytes at a time, may write up to copy_slack bytes past dst + count
+            inline void wild_copy( uint8_t* dst, const uint8_t* src, size_t count )
+            {
+                for ( uint8_t* dst_end = dst + count; dst < dst_end; dst += 8, src += 8 )
+                    copy_bytes( dst, src, 8 );
+            }
+        } // namespace lz4
+    } // namespace impl
+
+    // Worst-case size of a compressed block
+    [[nodiscard]] constexpr size_t lz4_compress_bound( size_t size )
+    {
+        return size + size / 255 + 16;
+    }
+
+    // Decompresses a block into dst, returns the decompressed size. Returns 0 if the block is
+    // malformed or does not fit into dst, as well as for an empty block.
+    // NOTE: every read and write is bounds-checked, so untrusted data is safe to decode
+    [[nodiscard]] inline size_t lz4_decompress( span<const uint8_t> src, span<uint8_t> dst )
+    {
+        using namespace impl::lz4;
+
+        const uint8_t* ip = src.data();
+        const uint8_t* ip_end = ip + src.size();
+        uint8_t*       op = dst.data();
+        uint8_t*       op_end = op + dst.size();
+
+        while ( ip != ip_end )
+        {
+            const uint8_t token = *ip++;
+
+            size_t length = token >> 4;
+
+            if ( length == 15 && !read_length( ip, ip_end, length ) )
+                return 0;
+
+            if ( length > static_cast<size_t>( ip_end - ip )
+                 || length > static_cast<size_t>( op_end - op ) )
+            {
+                return 0;
+            }
+
+            // Most literal runs are short, one fixed-size copy covers them
+            if ( length <= 16 && static_cast<size_t>( ip_end - ip ) >= 16
+                 && static_cast<size_t>( op_end - op ) >= 16 )
+            {
+                impl::copy_bytes( op, ip, 16 );
+            }
+            else if ( length > 0 )
+            {
+                // NOTE: an empty block decodes into an empty, possibly null, destination
+                impl::copy_bytes( op, ip, length );
+            }
+
+            ip += length;
+            op += length;
+
+            // NOTE: the last sequence has literals only
+            if ( ip == ip_end )
+                break;
+
+            if ( ip_end - ip < 2 )
+                return 0;
+
+            const size_t offset = ip[0] | ( ip[1] << 8 );
+            ip += 2;
+
+            if ( offset == 0 || offset > static_cast<size_t>( op - dst.data() ) )
+                return 0;
+
+            length = token & 15;
+
+            if ( length == 15 && !read_length( ip, ip_end, length ) )
+                return 0;
+
+            length += min_match;
+
+            if ( length > static_cast<size_t>( op_end - op ) )
+                return 0;
+
+            const uint8_t* match = op - offset;
+
+            if ( offset >= 8 && static_cast<size_t>( op_end - op ) >= length + copy_slack )
+            {
+                // NOTE: every 8 bytes read were written before, even if the ranges overlap
+                wild_copy( op, match, length );
+            }
+            else
+            {
+                // A short offset repeats a pattern, the copy has to go byte by byte
+                for ( size_t i = 0; i < length; ++i )
+                    op[i] = match[i];
+            }
+
+            op += length;
+        }
+
+        return static_cast<size_t>( op - dst.data() );
+    }
+} // namespace rtl
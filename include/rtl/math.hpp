@@ -10,29 +10,25 @@
  */
 #pragma once
 
+#include <rtl/algorithm.hpp>
+#include <rtl/bit.hpp>
+#include <rtl/int.hpp>
 #include <rtl/limits.hpp>
+#include <rtl/type_traits.hpp>
+
+#if defined( _MSC_VER ) && defined( _M_IX86 )
+    #include <intrin.h>
+#endif
 
 namespace rtl
 {
 
-#ifdef __GNUC__
     // NOTE: if x <= 0, then result is undefined
     [[nodiscard]] constexpr int ceil_log2_i( int x )
     {
-        return sizeof( int ) * 8 - __builtin_clz( x - 1 );
+        return bit_width( static_cast<unsigned>( x - 1 ) );
     }
-#else
-    // NOTE: if x <= 0, then result is undefined
-    [[nodiscard]] constexpr int ceil_log2_i( int x )
-    {
-        int result = 0;
 
-        for ( --x; x; x >>= 1 )
-            ++result;
-
-        return result;
-    }
-#endif
     // NOTE: if base == 0 and exponent == 0, then result is undefined
     [[nodiscard]] constexpr int pow_i( int base, int exponent )
     {
@@ -41,12 +37,110 @@ namespace rtl
 
         int result = 1;
 
-        for ( ; exponent > 0; --exponent )
+        // NOTE: the base is squared only while higher exponent bits remain
+        for ( ;; )
         {
-            result *= base;
+            if ( exponent & 1 )
+                result *= base;
+
+            exponent >>= 1;
+
+            if ( exponent == 0 )
+                break;
+
+            base *= base;
         }
 
         return result;
     }
 
+    // Full 64x64 -> 128 bit product, returns the lower half
+    // NOTE: built from 32-bit halves on x86, so no 64-bit multiplication helpers are needed
+    [[nodiscard]] constexpr uint64_t umul128( uint64_t a, uint64_t b, uint64_t& high )
+    {
+#ifdef __SIZEOF_INT128__
+        const unsigned __int128 product = static_cast<unsigned __int128>( a ) * b;
+
+        high = static_cast<uint64_t>( product >> 64 );
+        return static_cast<uint64_t>( product );
+#else
+        const uint64_t a_lo = static_cast<uint32_t>( a );
+        const uint64_t a_hi = a >> 32;
+        const uint64_t b_lo = static_cast<uint32_t>( b );
+        const uint64_t b_hi = b >> 32;
+
+        const uint64_t p0 = a_lo * b_lo;
+        const uint64_t p1 = a_lo * b_hi;
+        const uint64_t p2 = a_hi * b_lo;
+        const uint64_t p3 = a_hi * b_hi;
+
+        const uint64_t middle
+            = ( p0 >> 32 ) + static_cast<uint32_t>( p1 ) + static_cast<uint32_t>( p2 );
+
+        high = p3 + ( p1 >> 32 ) + ( p2 >> 32 ) + ( middle >> 32 );
+        return ( middle << 32 ) | static_cast<uint32_t>( p0 );
+#endif
+    }
+
+    // Lower half of a 64x64 bit product, i.e. the wrapping uint64_t multiplication
+    // NOTE: one 32x32 -> 64 bit product and two 32-bit ones on MSVC x86, where a plain 64-bit
+    // multiplication is a call to the CRT helper
+    [[nodiscard]] constexpr uint64_t mul64( uint64_t a, uint64_t b )
+    {
+#if defined( _MSC_VER ) && defined( _M_IX86 )
+        const uint32_t a_lo = static_cast<uint32_t>( a );
+        const uint32_t b_lo = static_cast<uint32_t>( b );
+        const uint32_t cross = a_lo * static_cast<uint32_t>( b >> 32 )
+                               + static_cast<uint32_t>( a >> 32 ) * b_lo;
+
+        return static_cast<uint64_t>( a_lo ) * b_lo + ( static_cast<uint64_t>( cross ) << 32 );
+#else
+        return a * b;
+#endif
+    }
+
+    // 64 / 32 bit unsigned division, returns the quotient
+    // NOTE: if divisor == 0, then result is undefined
+    [[nodiscard]] constexpr uint64_t udiv64_32( uint64_t  dividend,
+                                                uint32_t  divisor,
+                                                uint32_t& remainder )
+    {
+#if defined( _MSC_VER ) && defined( _M_IX86 )
+        // NOTE: two native 64/32 steps instead of the CRT 64-bit division helper
+        if ( !is_constant_evaluated() )
+        {
+            const uint32_t high = static_cast<uint32_t>( dividend >> 32 );
+            const uint32_t low = _udiv64( ( static_cast<uint64_t>( high % divisor ) << 32 )
+                                              | static_cast<uint32_t>( dividend ),
+                                          divisor,
+                                          &remainder );
+
+            return ( static_cast<uint64_t>( high / divisor ) << 32 ) | low;
+        }
+
+        // NOTE: shift-subtract with constant shifts only, used in constant evaluation
+        uint64_t quotient = 0;
+        uint64_t rest = 0;
+
+        for ( int i = 0; i < 64; ++i )
+        {
+            rest = ( rest << 1 ) | ( dividend >> 63 );
+            dividend <<= 1;
+            quotient <<= 1;
+
+            if ( rest >= divisor )
+            {
+                rest -= divisor;
+                quotient |= 1;
+            }
+        }
+
+        remainder = static_cast<uint32_t>( rest );
+        return quotient;
+#else
+        remainder = static_cast<uint32_t>( dividend % divisor );
+        return dividend / divisor;
+#endif
+    }
+
 } // namespace rtl
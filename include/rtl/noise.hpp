@@ -0,0 +1,763 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/fix.hpp>
+#include <rtl/int.hpp>
+#include <rtl/random.hpp>
+#include <rtl/span.hpp>
+#include <rtl/type_traits.hpp>
+
+#if RTL_ENABLE_SIMD
+    #include <emmintrin.h>
+#endif
+
+namespace rtl
+{
+    namespace impl
+    {
+        namespace noise
+        {
+            // Lanes of a noise kernel: 'real' coordinates, 'ints' lattice indices and 'mask'
+            // comparison results. Kernels are written once against this interface.
+            template<typename Real>
+            struct scalar_lanes
+            {
+                using real = Real;
+                using ints = int;
+                using mask = bool;
+
+                [[nodiscard]] static constexpr real constant( double value )
+                {
+                    return real( static_cast<float>( value ) );
+                }
+
+                [[nodiscard]] static constexpr real broadcast( real value )
+                {
+                    return value;
+                }
+
+                [[nodiscard]] static constexpr ints floor( real x )
+                {
+                    if constexpr ( is_same_v<real, float> )
+                    {
+                        const int i = static_cast<int>( x );
+                        return x < static_cast<float>( i ) ? i - 1 : i;
+                    }
+                    else
+                    {
+                        return static_cast<int>( x );
+                    }
+                }
+
+                [[nodiscard]] static constexpr real to_real( ints i )
+                {
+                    if constexpr ( is_same_v<real, float> )
+                        return static_cast<float>( i );
+                    else
+                        return real::from_raw(
+                            static_cast<int>( static_cast<unsigned>( i ) << real::fract_bits ) );
+                }
+
+                [[nodiscard]] static constexpr ints lookup( const uint8_t* table, ints index )
+                {
+                    return table[index];
+                }
+
+                [[nodiscard]] static constexpr mask test( ints value, int bit )
+                {
+                    return ( value & bit ) != 0;
+                }
+
+                [[nodiscard]] static constexpr mask less( ints value, int bound )
+                {
+                    return value < bound;
+                }
+
+                [[nodiscard]] static constexpr mask equal( ints value, int other )
+                {
+                    return value == other;
+                }
+
+                [[nodiscard]] static constexpr mask greater( real a, real b )
+                {
+                    return a > b;
+                }
+
+                [[nodiscard]] static constexpr mask greater_equal( real a, real b )
+                {
+                    return a >= b;
+                }
+
+                [[nodiscard]] static constexpr mask both( mask a, mask b )
+                {
+                    return a && b;
+                }
+
+                [[nodiscard]] static constexpr mask either( mask a, mask b )
+                {
+                    return a || b;
+                }
+
+                [[nodiscard]] static constexpr mask negate( mask a )
+                {
+                    return !a;
+                }
+
+                template<typename T>
+                [[nodiscard]] static constexpr T select( mask m, T a, T b )
+                {
+                    return m ? a : b;
+                }
+
+                [[nodiscard]] static constexpr real max( real a, real b )
+                {
+                    return a < b ? b : a;
+                }
+            };
+
+#if RTL_ENABLE_SIMD
+            struct f32x4
+            {
+                __m128 v;
+            };
+
+            struct i32x4
+            {
+                __m128i v;
+
+                i32x4() = default;
+
+                explicit i32x4( __m128i value )
+                    : v( value )
+                {
+                }
+
+                // cppcheck-suppress noExplicitConstructor
+                i32x4( int value )
+                    : v( _mm_set1_epi32( value ) )
+                {
+                }
+            };
+
+            inline f32x4 operator+( f32x4 a, f32x4 b )
+            {
+                return { _mm_add_ps( a.v, b.v ) };
+            }
+
+            inline f32x4 operator-( f32x4 a, f32x4 b )
+            {
+                return { _mm_sub_ps( a.v, b.v ) };
+            }
+
+            inline f32x4 operator*( f32x4 a, f32x4 b )
+            {
+                return { _mm_mul_ps( a.v, b.v ) };
+            }
+
+            inline f32x4 operator-( f32x4 a )
+            {
+                return { _mm_xor_ps( a.v, _mm_set1_ps( -0.0f ) ) };
+            }
+
+            inline i32x4 operator+( i32x4 a, i32x4 b )
+            {
+                return i32x4( _mm_add_epi32( a.v, b.v ) );
+            }
+
+            inline i32x4 operator&( i32x4 a, i32x4 b )
+            {
+                return i32x4( _mm_and_si128( a.v, b.v ) );
+            }
+
+            // Four lanes in SSE registers
+            // NOTE: SSE2 has no gather, table lookups are done one lane at a time
+            struct vector_lanes
+            {
+                using real = f32x4;
+                using ints = i32x4;
+                using mask = __m128i;
+
+                [[nodiscard]] static real constant( double value )
+                {
+                    return { _mm_set1_ps( static_cast<float>( value ) ) };
+                }
+
+                [[nodiscard]] static real broadcast( float value )
+                {
+                    return { _mm_set1_ps( value ) };
+                }
+
+                [[nodiscard]] static ints floor( real x )
+                {
+                    // NOTE: truncation rounds negative values up, those lanes are corrected by -1
+                    const __m128i truncated = _mm_cvttps_epi32( x.v );
+                    const __m128  above = _mm_cmpgt_ps( _mm_cvtepi32_ps( truncated ), x.v );
+
+                    return i32x4( _mm_add_epi32( truncated, _mm_castps_si128( above ) ) );
+                }
+
+                [[nodiscard]] static real to_real( ints i )
+                {
+                    return { _mm_cvtepi32_ps( i.v ) };
+                }
+
+                [[nodiscard]] static ints lookup( const uint8_t* table, ints index )
+                {
+                    alignas( 16 ) int32_t lanes[4];
+                    _mm_store_si128( reinterpret_cast<__m128i*>( lanes ), index.v );
+
+                    return i32x4( _mm_setr_epi32(
+                        table[lanes[0]], table[lanes[1]], table[lanes[2]], table[lanes[3]] ) );
+                }
+
+                [[nodiscard]] static mask test( ints value, int bit )
+                {
+                    const __m128i b = _mm_set1_epi32( bit );
+                    return _mm_cmpeq_epi32( _mm_and_si128( value.v, b ), b );
+                }
+
+                [[nodiscard]] static mask less( ints value, int bound )
+                {
+                    return _mm_cmplt_epi32( value.v, _mm_set1_epi32( bound ) );
+                }
+
+                [[nodiscard]] static mask equal( ints value, int other )
+                {
+                    return _mm_cmpeq_epi32( value.v, _mm_set1_epi32( other ) );
+                }
+
+                [[nodiscard]] static mask greater( real a, real b )
+                {
+                    return _mm_castps_si128( _mm_cmpgt_ps( a.v, b.v ) );
+                }
+
+                [[nodiscard]] static mask greater_equal( real a, real b )
+                {
+                    return _mm_castps_si128( _mm_cmpge_ps( a.v, b.v ) );
+                }
+
+                [[nodiscard]] static mask both( mask a, mask b )
+                {
+                    return _mm_and_si128( a, b );
+                }
+
+                [[nodiscard]] static mask either( mask a, mask b )
+                {
+                    return _mm_or_si128( a, b );
+                }
+
+                [[nodiscard]] static mask negate( mask a )
+                {
+                    return _mm_xor_si128( a, _mm_set1_epi32( -1 ) );
+                }
+
+                [[nodiscard]] static real select( mask m, real a, real b )
+                {
+                    const __m128 bits = _mm_castsi128_ps( m );
+                    return { _mm_or_ps( _mm_and_ps( bits, a.v ), _mm_andnot_ps( bits, b.v ) ) };
+                }
+
+                [[nodiscard]] static ints select( mask m, ints a, ints b )
+                {
+                    return i32x4(
+                        _mm_or_si128( _mm_and_si128( m, a.v ), _mm_andnot_si128( m, b.v ) ) );
+                }
+
+                [[nodiscard]] static real max( real a, real b )
+                {
+                    return { _mm_max_ps( a.v, b.v ) };
+                }
+            };
+#endif
+
+            template<typename L>
+            [[nodiscard]] typename L::real lerp( typename L::real a,
+                                                 typename L::real b,
+                                                 typename L::real t )
+            {
+                return a + ( b - a ) * t;
+            }
+
+            // 6t^5 - 15t^4 + 10t^3
+            template<typename L>
+            [[nodiscard]] typename L::real fade( typename L::real t )
+            {
+                return t * t * t
+                       * ( t * ( t * L::constant( 6 ) - L::constant( 15 ) ) + L::constant( 10 ) );
+            }
+
+            // Lattice value in [-1, 1] from a hash byte
+            // NOTE: the hash is centred first, so fix formats with 7 integer bits hold it
+            template<typename L>
+            [[nodiscard]] typename L::real value_at( typename L::ints hash )
+            {
+                using ints = typename L::ints;
+
+                return L::to_real( hash + ints( -128 ) ) * L::constant( 2.0 / 255 )
+                       + L::constant( 1.0 / 255 );
+            }
+
+            // Gradients (+-1, +-1)
+            template<typename L>
+            [[nodiscard]] typename L::real gradient( typename L::ints hash,
+                                                     typename L::real x,
+                                                     typename L::real y )
+            {
+                return L::select( L::test( hash, 1 ), -x, x )
+                       + L::select( L::test( hash, 2 ), -y, y );
+            }
+
+            // Gradients to the edge midpoints of a cube, as in the improved Perlin noise
+            template<typename L>
+            [[nodiscard]] typename L::real gradient( typename L::ints hash,
+                                                     typename L::real x,
+                                                     typename L::real y,
+                                                     typename L::real z )
+            {
+                const auto h = hash & 15;
+
+                const auto u = L::select( L::less( h, 8 ), x, y );
+                const auto w = L::select( L::either( L::equal( h, 12 ), L::equal( h, 14 ) ), x, z );
+                const auto v = L::select( L::less( h, 4 ), y, w );
+
+                return L::select( L::test( h, 1 ), -u, u ) + L::select( L::test( h, 2 ), -v, v );
+            }
+
+            template<typename L>
+            [[nodiscard]] typename L::real value( const uint8_t*   perm,
+                                                  typename L::real x,
+                                                  typename L::real y )
+            {
+                const auto ix = L::floor( x );
+                const auto iy = L::floor( y );
+
+                const auto u = fade<L>( x - L::to_real( ix ) );
+                const auto v = fade<L>( y - L::to_real( iy ) );
+
+                const auto y0 = iy & 255;
+                const auto y1 = ( iy + 1 ) & 255;
+                const auto a = L::lookup( perm, ix & 255 );
+                const auto b = L::lookup( perm, ( ix + 1 ) & 255 );
+
+                return lerp<L>( lerp<L>( value_at<L>( L::lookup( perm, a + y0 ) ),
+                                         value_at<L>( L::lookup( perm, b + y0 ) ),
+                                         u ),
+                                lerp<L>( value_at<L>( L::lookup( perm, a + y1 ) ),
+                                         value_at<L>( L::lookup( perm, b + y1 ) ),
+                                         u ),
+                                v );
+            }
+
+            template<typename L>
+            [[nodiscard]] typename L::real value( const uint8_t*   perm,
+                                                  typename L::real x,
+                                                  typename L::real y,
+                                                  typename L::real z )
+            {
+                const auto ix = L::floor( x );
+                const auto iy = L::floor( y );
+                const auto iz = L::floor( z );
+
+                const auto u = fade<L>( x - L::to_real( ix ) );
+                const auto v = fade<L>( y - L::to_real( iy ) );
+                const auto w = fade<L>( z - L::to_real( iz ) );
+
+                const auto y0 = iy & 255;
+                const auto y1 = ( iy + 1 ) & 255;
+                const auto z0 = iz & 255;
+                const auto z1 = ( iz + 1 ) & 255;
+                const auto a = L::lookup( perm, ix & 255 );
+                const auto b = L::lookup( perm, ( ix + 1 ) & 255 );
+                const auto a0 = L::lookup( perm, a + y0 );
+                const auto a1 = L::lookup( perm, a + y1 );
+                const auto b0 = L::lookup( perm, b + y0 );
+                const auto b1 = L::lookup( perm, b + y1 );
+
+                const auto at = [perm]( typename L::ints hash ) {
+                    return value_at<L>( L::lookup( perm, hash ) );
+                };
+
+                return lerp<L>( lerp<L>( lerp<L>( at( a0 + z0 ), at( b0 + z0 ), u ),
+                                         lerp<L>( at( a1 + z0 ), at( b1 + z0 ), u ),
+                                         v ),
+                                lerp<L>( lerp<L>( at( a0 + z1 ), at( b0 + z1 ), u ),
+                                         lerp<L>( at( a1 + z1 ), at( b1 + z1 ), u ),
+                                         v ),
+                                w );
+            }
+
+            template<typename L>
+            [[nodiscard]] typename L::real perlin( const uint8_t*   perm,
+                                                   typename L::real x,
+                                                   typename L::real y )
+            {
+                const auto ix = L::floor( x );
+                const auto iy = L::floor( y );
+
+                const auto fx = x - L::to_real( ix );
+                const auto fy = y - L::to_real( iy );
+                const auto gx = fx - L::constant( 1 );
+                const auto gy = fy - L::constant( 1 );
+
+                const auto y0 = iy & 255;
+                const auto y1 = ( iy + 1 ) & 255;
+                const auto a = L::lookup( perm, ix & 255 );
+                const auto b = L::lookup( perm, ( ix + 1 ) & 255 );
+
+                const auto u = fade<L>( fx );
+
+                return lerp<L>( lerp<L>( gradient<L>( L::lookup( perm, a + y0 ), fx, fy ),
+                                         gradient<L>( L::lookup( perm, b + y0 ), gx, fy ),
+                                         u ),
+                                lerp<L>( gradient<L>( L::lookup( perm, a + y1 ), fx, gy ),
+                                         gradient<L>( L::lookup( perm, b + y1 ), gx, gy ),
+                                         u ),
+                                fade<L>( fy ) );
+            }
+
+            template<typename L>
+            [[nodiscard]] typename L::real perlin( const uint8_t*   perm,
+                                                   typename L::real x,
+                                                   typename L::real y,
+                                                   typename L::real z )
+            {
+                const auto ix = L::floor( x );
+                const auto iy = L::floor( y );
+                const auto iz = L::floor( z );
+
+                const auto fx = x - L::to_real( ix );
+                const auto fy = y - L::to_real( iy );
+                const auto fz = z - L::to_real( iz );
+                const auto gx = fx - L::constant( 1 );
+                const auto gy = fy - L::constant( 1 );
+                const auto gz = fz - L::constant( 1 );
+
+                const auto y0 = iy & 255;
+                const auto y1 = ( iy + 1 ) & 255;
+                const auto z0 = iz & 255;
+                const auto z1 = ( iz + 1 ) & 255;
+                const auto a = L::lookup( perm, ix & 255 );
+                const auto b = L::lookup( perm, ( ix + 1 ) & 255 );
+                const auto a0 = L::lookup( perm, a + y0 );
+                const auto a1 = L::lookup( perm, a + y1 );
+                const auto b0 = L::lookup( perm, b + y0 );
+                const auto b1 = L::lookup( perm, b + y1 );
+
+                const auto u = fade<L>( fx );
+                const auto v = fade<L>( fy );
+
+                const auto at = [perm]( typename L::ints hash,
+                                        typename L::real px,
+                                        typename L::real py,
+                                        typename L::real pz ) {
+                    return gradient<L>( L::lookup( perm, hash ), px, py, pz );
+                };
+
+                const auto front = lerp<L>(
+                    lerp<L>( at( a0 + z0, fx, fy, fz ), at( b0 + z0, gx, fy, fz ), u ),
+                    lerp<L>( at( a1 + z0, fx, gy, fz ), at( b1 + z0, gx, gy, fz ), u ),
+                    v );
+
+                const auto back = lerp<L>(
+                    lerp<L>( at( a0 + z1, fx, fy, gz ), at( b0 + z1, gx, fy, gz ), u ),
+                    lerp<L>( at( a1 + z1, fx, gy, gz ), at( b1 + z1, gx, gy, gz ), u ),
+                    v );
+
+                return lerp<L>( front, back, fade<L>( fz ) );
+            }
+
+            // Contribution of one simplex corner, (r2 - |d|^2)^4 * gradient
+            template<typename L, typename... Coordinates>
+            [[nodiscard]] typename L::real corner( typename L::real r2,
+                                                   typename L::ints hash,
+                                                   Coordinates... d )
+            {
+                auto t = L::max( r2 - ( ( d * d ) + ... ), L::constant( 0 ) );
+                t = t * t;
+
+                return t * t * gradient<L>( hash, d... );
+            }
+
+            // Stefan Gustavson, "Simplex noise demystified", 2005
+            template<typename L>
+            [[nodiscard]] typename L::real simplex( const uint8_t*   perm,
+                                                    typename L::real x,
+                                                    typename L::real y )
+            {
+                constexpr double f2 = 0.36602540378443864676; // (sqrt(3) - 1) / 2
+                constexpr double g2 = 0.21132486540518711775; // (3 - sqrt(3)) / 6
+
+                const auto s = ( x + y ) * L::constant( f2 );
+                const auto i = L::floor( x + s );
+                const auto j = L::floor( y + s );
+                const auto t = L::to_real( i + j ) * L::constant( g2 );
+
+                const auto x0 = x - ( L::to_real( i ) - t );
+                const auto y0 = y - ( L::to_real( j ) - t );
+
+                // NOTE: lower or upper triangle of the skewed cell
+                const auto lower = L::greater( x0, y0 );
+                const auto i1 = L::select( lower, typename L::ints( 1 ), typename L::ints( 0 ) );
+                const auto j1 = L::select( lower, typename L::ints( 0 ), typename L::ints( 1 ) );
+
+                const auto x1 = x0 - L::to_real( i1 ) + L::constant( g2 );
+                const auto y1 = y0 - L::to_real( j1 ) + L::constant( g2 );
+                const auto x2 = x0 - L::constant( 1 - 2 * g2 );
+                const auto y2 = y0 - L::constant( 1 - 2 * g2 );
+
+                const auto ii = i & 255;
+                const auto jj = j & 255;
+
+                const auto h0 = L::lookup( perm, L::lookup( perm, ii ) + jj );
+                const auto h1 = L::lookup( perm, L::lookup( perm, ii + i1 ) + jj + j1 );
+                const auto h2 = L::lookup( perm, L::lookup( perm, ii + 1 ) + jj + 1 );
+
+                const auto r2 = L::constant( 0.5 );
+
+                return L::constant( 70 )
+                       * ( corner<L>( r2, h0, x0, y0 ) + corner<L>( r2, h1, x1, y1 )
+                           + corner<L>( r2, h2, x2, y2 ) );
+            }
+
+            template<typename L>
+            [[nodiscard]] typename L::real simplex( const uint8_t*   perm,
+                                                    typename L::real x,
+                                                    typename L::real y,
+                                                    typename L::real z )
+            {
+                constexpr double f3 = 1.0 / 3;
+                constexpr double g3 = 1.0 / 6;
+
+                using ints = typename L::ints;
+
+                const auto s = ( x + y + z ) * L::constant( f3 );
+                const auto i = L::floor( x + s );
+                const auto j = L::floor( y + s );
+                const auto k = L::floor( z + s );
+                const auto t = L::to_real( i + j + k ) * L::constant( g3 );
+
+                const auto x0 = x - ( L::to_real( i ) - t );
+                const auto y0 = y - ( L::to_real( j ) - t );
+                const auto z0 = z - ( L::to_real( k ) - t );
+
+                // NOTE: ranks of the coordinates select one of six simplices, branch free
+                const auto xy = L::greater_equal( x0, y0 );
+                const auto yz = L::greater_equal( y0, z0 );
+                const auto xz = L::greater_equal( x0, z0 );
+
+                const auto bit = []( typename L::mask m ) {
+                    return L::select( m, ints( 1 ), ints( 0 ) );
+                };
+
+                const auto i1 = bit( L::both( xy, xz ) );
+                const auto j1 = bit( L::both( L::negate( xy ), yz ) );
+                const auto k1 = bit( L::both( L::negate( xz ), L::negate( yz ) ) );
+                const auto i2 = bit( L::either( xy, xz ) );
+                const auto j2 = bit( L::either( L::negate( xy ), yz ) );
+                const auto k2 = bit( L::either( L::negate( xz ), L::negate( yz ) ) );
+
+                const auto x1 = x0 - L::to_real( i1 ) + L::constant( g3 );
+                const auto y1 = y0 - L::to_real( j1 ) + L::constant( g3 );
+                const auto z1 = z0 - L::to_real( k1 ) + L::constant( g3 );
+                const auto x2 = x0 - L::to_real( i2 ) + L::constant( 2 * g3 );
+                const auto y2 = y0 - L::to_real( j2 ) + L::constant( 2 * g3 );
+                const auto z2 = z0 - L::to_real( k2 ) + L::constant( 2 * g3 );
+                const auto x3 = x0 - L::constant( 1 - 3 * g3 );
+                const auto y3 = y0 - L::constant( 1 - 3 * g3 );
+                const auto z3 = z0 - L::constant( 1 - 3 * g3 );
+
+                const auto ii = i & 255;
+                const auto jj = j & 255;
+                const auto kk = k & 255;
+
+                const auto hash = [perm, ii, jj, kk]( ints di, ints dj, ints dk ) {
+                    return L::lookup(
+                        perm, L::lookup( perm, L::lookup( perm, ii + di ) + jj + dj ) + kk + dk );
+                };
+
+                const auto r2 = L::constant( 0.6 );
+
+                return L::constant( 32 )
+                       * ( corner<L>( r2, hash( 0, 0, 0 ), x0, y0, z0 )
+                           + corner<L>( r2, hash( i1, j1, k1 ), x1, y1, z1 )
+                           + corner<L>( r2, hash( i2, j2, k2 ), x2, y2, z2 )
+                           + corner<L>( r2, hash( 1, 1, 1 ), x3, y3, z3 ) );
+            }
+
+            // out[i] = kernel(x + dx * i), four pixels per step for float rows, fix rows are scalar
+            template<typename Real, typename Kernel>
+            void fill_row( span<Real> out, Real x, Real dx, Kernel kernel )
+            {
+                size_t i = 0;
+
+#if RTL_ENABLE_SIMD
+                if constexpr ( is_same_v<Real, float> )
+                {
+                    const __m128  base = _mm_set1_ps( x );
+                    const __m128  step = _mm_set1_ps( dx );
+                    const __m128i lanes = _mm_setr_epi32( 0, 1, 2, 3 );
+
+                    for ( ; i + 4 <= out.size(); i += 4 )
+                    {
+                        // NOTE: same x + dx * i as the scalar tail, so results do not depend on
+                        // the lane a pixel falls into
+                        const __m128 index = _mm_cvtepi32_ps(
+                            _mm_add_epi32( _mm_set1_epi32( static_cast<int>( i ) ), lanes ) );
+
+                        const f32x4 xs { _mm_add_ps( base, _mm_mul_ps( step, index ) ) };
+                        _mm_storeu_ps( out.data() + i, kernel( vector_lanes(), xs ).v );
+                    }
+                }
+#endif
+
+                for ( ; i < out.size(); ++i )
+                {
+                    if constexpr ( is_same_v<Real, float> )
+                        out[i] = kernel( scalar_lanes<Real>(), x + dx * static_cast<float>( i ) );
+                    else
+                        out[i] = kernel( scalar_lanes<Real>(), x + dx * static_cast<int>( i ) );
+                }
+            }
+        } // namespace noise
+    }     // namespace impl
+
+    // Coherent noise over a seeded permutation of 256 lattice hashes, period 256 on every axis.
+    // Coordinates are float or fix<int, F>. The fix variants are computed in integer arithmetic
+    // and give the same bits on every platform.
+    //
+    // With RTL_ENABLE_SIMD float rows run four pixels at a time on SSE2 lanes. fix rows are
+    // computed one pixel at a time: SSE2 has neither a signed 32-bit multiply nor a gather, and
+    // integer lanes that reproduce the fix products turned out slower than the scalar code.
+    //
+    // Outputs are roughly in [-1, 1]: value noise exactly, gradient and simplex noise are
+    // scaled to reach about +-1.
+    class noise final
+    {
+    public:
+        template<typename Engine>
+        void init( Engine& engine )
+        {
+            for ( int i = 0; i < 256; ++i )
+                m_perm[i] = static_cast<uint8_t>( i );
+
+            // NOTE: Fisher-Yates shuffle
+            for ( int i = 255; i > 0; --i )
+            {
+                const int j = uniform_int<int>( 0, i )( engine );
+
+                const uint8_t t = m_perm[i];
+                m_perm[i] = m_perm[j];
+                m_perm[j] = t;
+            }
+
+            for ( int i = 0; i < 256; ++i )
+                m_perm[i + 256] = m_perm[i];
+        }
+
+        // Value noise, smooth interpolation of random lattice values
+        template<typename Real>
+        [[nodiscard]] Real value( Real x, Real y ) const
+        {
+            return impl::noise::value<impl::noise::scalar_lanes<Real>>( m_perm, x, y );
+        }
+
+        template<typename Real>
+        [[nodiscard]] Real value( Real x, Real y, Real z ) const
+        {
+            return impl::noise::value<impl::noise::scalar_lanes<Real>>( m_perm, x, y, z );
+        }
+
+        // Gradient noise, improved Perlin noise
+        template<typename Real>
+        [[nodiscard]] Real perlin( Real x, Real y ) const
+        {
+            return impl::noise::perlin<impl::noise::scalar_lanes<Real>>( m_perm, x, y );
+        }
+
+        template<typename Real>
+        [[nodiscard]] Real perlin( Real x, Real y, Real z ) const
+        {
+            return impl::noise::perlin<impl::noise::scalar_lanes<Real>>( m_perm, x, y, z );
+        }
+
+        template<typename Real>
+        [[nodiscard]] Real simplex( Real x, Real y ) const
+        {
+            return impl::noise::simplex<impl::noise::scalar_lanes<Real>>( m_perm, x, y );
+        }
+
+        template<typename Real>
+        [[nodiscard]] Real simplex( Real x, Real y, Real z ) const
+        {
+            return impl::noise::simplex<impl::noise::scalar_lanes<Real>>( m_perm, x, y, z );
+        }
+
+        // Rows: out[i] = noise(x + dx * i, y[, z]), e.g. one scanline of a texture
+        template<typename Real>
+        void value_row( span<Real> out, Real x, Real dx, Real y ) const
+        {
+            impl::noise::fill_row( out, x, dx, [this, y]( auto lanes, auto xs ) {
+                using L = decltype( lanes );
+                return impl::noise::value<L>( m_perm, xs, L::broadcast( y ) );
+            } );
+        }
+
+        template<typename Real>
+        void value_row( span<Real> out, Real x, Real dx, Real y, Real z ) const
+        {
+            impl::noise::fill_row( out, x, dx, [this, y, z]( auto lanes, auto xs ) {
+                using L = decltype( lanes );
+                return impl::noise::value<L>( m_perm, xs, L::broadcast( y ), L::broadcast( z ) );
+            } );
+        }
+
+        template<typename Real>
+        void perlin_row( span<Real> out, Real x, Real dx, Real y ) const
+        {
+            impl::noise::fill_row( out, x, dx, [this, y]( auto lanes, auto xs ) {
+                using L = decltype( lanes );
+                return impl::noise::perlin<L>( m_perm, xs, L::broadcast( y ) );
+            } );
+        }
+
+        template<typename Real>
+        void perlin_row( span<Real> out, Real x, Real dx, Real y, Real z ) const
+        {
+            impl::noise::fill_row( out, x, dx, [this, y, z]( auto lanes, auto xs ) {
+                using L = decltype( lanes );
+                return impl::noise::perlin<L>( m_perm, xs, L::broadcast( y ), L::broadcast( z ) );
+            } );
+        }
+
+        template<typename Real>
+        void simplex_row( span<Real> out, Real x, Real dx, Real y ) const
+        {
+            impl::noise::fill_row( out, x, dx, [this, y]( auto lanes, auto xs ) {
+                using L = decltype( lanes );
+                return impl::noise::simplex<L>( m_perm, xs, L::broadcast( y ) );
+            } );
+        }
+
+        template<typename Real>
+        void simplex_row( span<Real> out, Real x, Real dx, Real y, Real z ) const
+        {
+            impl::noise::fill_row( out, x, dx, [this, y, z]( auto lanes, auto xs ) {
+                using L = decltype( lanes );
+                return impl::noise::simplex<L>( m_perm, xs, L::broadcast( y ), L::broadcast( z ) );
+            } );
+        }
+
+    private:
+        // NOTE: stored twice, so that perm[perm[i] + j] needs no wrapping
+        uint8_t m_perm[512];
+    };
+} // namespace rtl
@@ -10,12 +10,14 @@
  */
 #pragma once
 
+#include <rtl/bit.hpp>
+#include <rtl/fix.hpp>
 #include <rtl/int.hpp>
+#include <rtl/math.hpp>
+#include <rtl/span.hpp>
 
 namespace rtl
 {
-    // TODO: implement STL-like API
-
     // Complementary-multiply-with-carry (CMWC) pseudorandom number generator.
     // https://en.wikipedia.org/wiki/Multiply-with-carry_pseudorandom_number_generator
     template<int cycle_length>
@@ -60,9 +62,580 @@ namespace rtl
             return ( queue[index] = r - x );
         }
 
+        constexpr void fill( span<uint32_t> out )
+        {
+            for ( uint32_t& value : out )
+                value = rand();
+        }
+
         uint32_t queue[cycle_length];
         uint32_t carry;
         uint32_t index;
     };
 
+    // SplitMix64 generator, counter based, so any output is reachable in constant time.
+    // Mostly used to seed the other engines.
+    // https://prng.di.unimi.it/splitmix64.c
+    class splitmix64 final
+    {
+    public:
+        static constexpr uint64_t gamma = 0x9e3779b97f4a7c15ull;
+
+        constexpr void init( uint64_t seed )
+        {
+            state = seed;
+        }
+
+        [[nodiscard]] constexpr uint64_t rand64()
+        {
+            state += gamma;
+            return mix( state );
+        }
+
+        [[nodiscard]] constexpr uint32_t rand()
+        {
+            return static_cast<uint32_t>( rand64() >> 32 );
+        }
+
+        // Skips 'count' outputs
+        constexpr void advance( uint64_t count )
+        {
+            state += mul64( count, gamma );
+        }
+
+        // Same values as successive rand() calls
+        constexpr void fill( span<uint32_t> out )
+        {
+            size_t i = 0;
+
+            // NOTE: outputs do not depend on each other, so four of them are in flight per step
+            for ( ; i + 4 <= out.size(); i += 4 )
+            {
+                out[i + 0] = static_cast<uint32_t>( mix( state + gamma * 1 ) >> 32 );
+                out[i + 1] = static_cast<uint32_t>( mix( state + gamma * 2 ) >> 32 );
+                out[i + 2] = static_cast<uint32_t>( mix( state + gamma * 3 ) >> 32 );
+                out[i + 3] = static_cast<uint32_t>( mix( state + gamma * 4 ) >> 32 );
+
+                state += gamma * 4;
+            }
+
+            for ( ; i < out.size(); ++i )
+                out[i] = rand();
+        }
+
+        [[nodiscard]] static constexpr uint64_t mix( uint64_t z )
+        {
+            z = mul64( z ^ ( z >> 30 ), 0xbf58476d1ce4e5b9ull );
+            z = mul64( z ^ ( z >> 27 ), 0x94d049bb133111ebull );
+            return z ^ ( z >> 31 );
+        }
+
+        uint64_t state;
+    };
+
+    // xoshiro256** generator, 2^256 - 1 period. Parallel streams are made with jump(): seed one
+    // engine, then copy it and jump once more for every next worker.
+    // https://prng.di.unimi.it/xoshiro256starstar.c
+    class xoshiro256ss final
+    {
+    public:
+        constexpr void init( uint64_t seed )
+        {
+            splitmix64 seeder {};
+            seeder.init( seed );
+
+            for ( uint64_t& word : s )
+                word = seeder.rand64();
+        }
+
+        [[nodiscard]] constexpr uint64_t rand64()
+        {
+            const uint64_t result = mul64( rotl( mul64( s[1], 5 ), 7 ), 9 );
+            const uint64_t t = s[1] << 17;
+
+            s[2] ^= s[0];
+            s[3] ^= s[1];
+            s[1] ^= s[2];
+            s[0] ^= s[3];
+            s[2] ^= t;
+            s[3] = rotl( s[3], 45 );
+
+            return result;
+        }
+
+        [[nodiscard]] constexpr uint32_t rand()
+        {
+            return static_cast<uint32_t>( rand64() >> 32 );
+        }
+
+        // Equivalent to 2^128 calls of rand64(), gives 2^128 non-overlapping streams
+        constexpr void jump()
+        {
+            constexpr uint64_t polynomial[] = { 0x180ec6d33cfd0abaull,
+                                                0xd5a61266f0c9392cull,
+                                                0xa9582618e03fc9aaull,
+                                                0x39abdc4529b1661cull };
+            apply( polynomial );
+        }
+
+        // Equivalent to 2^192 calls of rand64(), gives 2^64 starting points for jump()
+        constexpr void long_jump()
+        {
+            constexpr uint64_t polynomial[] = { 0x76e15d3efefdcbbfull,
+                                                0xc5004e441c522fb3ull,
+                                                0x77710069854ee241ull,
+                                                0x39109bb02acbe635ull };
+            apply( polynomial );
+        }
+
+        // Same values as successive rand() calls
+        constexpr void fill( span<uint32_t> out )
+        {
+            for ( uint32_t& value : out )
+                value = rand();
+        }
+
+        uint64_t s[4];
+
+    private:
+        constexpr void apply( const uint64_t ( &polynomial )[4] )
+        {
+            uint64_t t[4] = {};
+
+            for ( uint64_t word : polynomial )
+            {
+                // NOTE: bits are consumed with constant shifts only
+                for ( int b = 0; b < 64; ++b, word >>= 1 )
+                {
+                    if ( word & 1 )
+                    {
+                        t[0] ^= s[0];
+                        t[1] ^= s[1];
+                        t[2] ^= s[2];
+                        t[3] ^= s[3];
+                    }
+
+                    (void)rand64();
+                }
+            }
+
+            s[0] = t[0];
+            s[1] = t[1];
+            s[2] = t[2];
+            s[3] = t[3];
+        }
+    };
+
+    // PCG32 generator (XSH RR 64/32). Engines with different sequence numbers produce
+    // independent streams; advance() skips within a stream in at most 64 steps.
+    // https://www.pcg-random.org/
+    class pcg32 final
+    {
+    public:
+        static constexpr uint64_t multiplier = 6364136223846793005ull;
+
+        constexpr void init( uint64_t seed, uint64_t sequence = 0 )
+        {
+            state = 0;
+            increment = ( sequence << 1 ) | 1;
+            (void)rand();
+            state += seed;
+            (void)rand();
+        }
+
+        [[nodiscard]] constexpr uint32_t rand()
+        {
+            const uint64_t old = state;
+            state = mul64( old, multiplier ) + increment;
+            return output( old );
+        }
+
+        // Skips 'count' outputs
+        constexpr void advance( uint64_t count )
+        {
+            uint64_t step_multiplier = multiplier;
+            uint64_t step_increment = increment;
+            uint64_t total_multiplier = 1;
+            uint64_t total_increment = 0;
+
+            for ( ; count; count >>= 1 )
+            {
+                if ( count & 1 )
+                {
+                    total_multiplier = mul64( total_multiplier, step_multiplier );
+                    total_increment = mul64( total_increment, step_multiplier ) + step_increment;
+                }
+
+                step_increment = mul64( step_increment, step_multiplier + 1 );
+                step_multiplier = mul64( step_multiplier, step_multiplier );
+            }
+
+            state = mul64( total_multiplier, state ) + total_increment;
+        }
+
+        // Same values as successive rand() calls
+        constexpr void fill( span<uint32_t> out )
+        {
+            // NOTE: states 1..4 steps ahead are computed from the current one, so the four
+            // multiplications do not wait on each other
+            constexpr uint64_t a1 = multiplier;
+            constexpr uint64_t a2 = a1 * multiplier;
+            constexpr uint64_t a3 = a2 * multiplier;
+            constexpr uint64_t a4 = a3 * multiplier;
+
+            const uint64_t c1 = increment;
+            const uint64_t c2 = mul64( c1, multiplier ) + increment;
+            const uint64_t c3 = mul64( c2, multiplier ) + increment;
+            const uint64_t c4 = mul64( c3, multiplier ) + increment;
+
+            size_t i = 0;
+
+            for ( ; i + 4 <= out.size(); i += 4 )
+            {
+                out[i + 0] = output( state );
+                out[i + 1] = output( mul64( a1, state ) + c1 );
+                out[i + 2] = output( mul64( a2, state ) + c2 );
+                out[i + 3] = output( mul64( a3, state ) + c3 );
+
+                state = mul64( a4, state ) + c4;
+            }
+
+            for ( ; i < out.size(); ++i )
+                out[i] = rand();
+        }
+
+        uint64_t state;
+        uint64_t increment;
+
+    private:
+        [[nodiscard]] static constexpr uint32_t output( uint64_t value )
+        {
+            const uint32_t xorshifted = static_cast<uint32_t>( ( ( value >> 18 ) ^ value ) >> 27 );
+            return rotr( xorshifted, static_cast<int>( value >> 59 ) );
+        }
+    };
+
+    namespace impl
+    {
+        namespace ziggurat
+        {
+            inline constexpr double ln2 = 0.69314718055994530942;
+
+            // NOTE: double helpers for the table generation, also used on the rare slow paths
+            [[nodiscard]] constexpr double exp( double x )
+            {
+                // exp(x) = 2^k * exp(r), |r| <= ln2 / 2
+                const int    k = static_cast<int>( x / ln2 + ( x < 0 ? -0.5 : 0.5 ) );
+                const double r = x - k * ln2;
+
+                double term = 1;
+                double sum = 1;
+
+                for ( int n = 1; n < 18; ++n )
+                {
+                    term *= r / n;
+                    sum += term;
+                }
+
+                for ( int i = 0; i < k; ++i )
+                    sum *= 2;
+
+                for ( int i = 0; i > k; --i )
+                    sum /= 2;
+
+                return sum;
+            }
+
+            // NOTE: x > 0
+            [[nodiscard]] constexpr double log( double x )
+            {
+                int k = 0;
+
+                for ( ; x >= 2; ++k )
+                    x /= 2;
+
+                for ( ; x < 1; --k )
+                    x *= 2;
+
+                // ln(x) = 2 * atanh((x-1)/(x+1)), the argument is below 1/3
+                const double z = ( x - 1 ) / ( x + 1 );
+
+                double power = z;
+                double sum = z;
+
+                for ( int n = 1; n < 20; ++n )
+                {
+                    power *= z * z;
+                    sum += power / ( 2 * n + 1 );
+                }
+
+                return 2 * sum + k * ln2;
+            }
+
+            // NOTE: x >= 0
+            [[nodiscard]] constexpr double sqrt( double x )
+            {
+                double y = x > 1 ? x : 1;
+
+                for ( int i = 0; i < 40; ++i )
+                    y = ( y + x / y ) / 2;
+
+                return y;
+            }
+
+            inline constexpr int    layers = 128;
+            inline constexpr double r = 3.442619855899;      // start of the tail
+            inline constexpr double v = 9.91256303526217e-3; // area of a layer
+
+            struct tables
+            {
+                uint32_t k[layers]; // thresholds of the fast path, |hz| < k[iz]
+                float    w[layers]; // layer widths scaled by 2^-31
+                float    f[layers]; // density at the layer boundaries
+            };
+
+            // Marsaglia & Tsang, "The Ziggurat Method for Generating Random Variables", 2000
+            [[nodiscard]] constexpr tables make_tables()
+            {
+                constexpr double m = 2147483648.0;
+
+                tables t {};
+
+                double       dn = r;
+                double       tn = r;
+                const double q = v / exp( -0.5 * dn * dn );
+
+                t.k[0] = static_cast<uint32_t>( ( dn / q ) * m );
+                t.k[1] = 0;
+
+                t.w[0] = static_cast<float>( q / m );
+                t.w[layers - 1] = static_cast<float>( dn / m );
+
+                t.f[0] = 1.0f;
+                t.f[layers - 1] = static_cast<float>( exp( -0.5 * dn * dn ) );
+
+                for ( int i = layers - 2; i >= 1; --i )
+                {
+                    dn = sqrt( -2 * log( v / dn + exp( -0.5 * dn * dn ) ) );
+
+                    t.k[i + 1] = static_cast<uint32_t>( ( dn / tn ) * m );
+                    tn = dn;
+
+                    t.f[i] = static_cast<float>( exp( -0.5 * dn * dn ) );
+                    t.w[i] = static_cast<float>( dn / m );
+                }
+
+                return t;
+            }
+
+            inline constexpr tables normal = make_tables();
+
+            // Uniform in (0, 1]
+            template<typename Engine>
+            [[nodiscard]] constexpr double uniform( Engine& engine )
+            {
+                return ( ( engine.rand() >> 8 ) + 1 ) * ( 1.0 / ( 1 << 24 ) );
+            }
+
+            // Rejection part, taken when the fast path fails (about 1.2% of the samples)
+            template<typename Engine>
+            [[nodiscard]] float sample_slow( Engine& engine, int32_t hz )
+            {
+                for ( ;; )
+                {
+                    const uint32_t iz = static_cast<uint32_t>( hz ) & ( layers - 1 );
+                    const double   x = hz * static_cast<double>( normal.w[iz] );
+
+                    if ( iz == 0 )
+                    {
+                        // NOTE: the tail beyond r, Marsaglia's exponential method
+                        double tx = 0;
+                        double ty = 0;
+
+                        do
+                        {
+                            tx = -log( uniform( engine ) ) / r;
+                            ty = -log( uniform( engine ) );
+                        } while ( ty + ty < tx * tx );
+
+                        return static_cast<float>( hz > 0 ? r + tx : -r - tx );
+                    }
+
+                    const double f = normal.f[iz];
+                    const double g = normal.f[iz - 1];
+
+                    if ( f + uniform( engine ) * ( g - f ) < exp( -0.5 * x * x ) )
+                        return static_cast<float>( x );
+
+                    hz = static_cast<int32_t>( engine.rand() );
+
+                    const uint32_t next = static_cast<uint32_t>( hz ) & ( layers - 1 );
+                    if ( ( hz < 0 ? 0u - static_cast<uint32_t>( hz ) : static_cast<uint32_t>( hz ) )
+                         < normal.k[next] )
+                        return hz * normal.w[next];
+                }
+            }
+
+            // Standard normal from one engine output on the fast path
+            template<typename Engine>
+            [[nodiscard]] float sample( Engine& engine, uint32_t bits )
+            {
+                const int32_t  hz = static_cast<int32_t>( bits );
+                const uint32_t iz = bits & ( layers - 1 );
+
+                const uint32_t magnitude = hz < 0 ? 0u - bits : bits;
+                if ( magnitude < normal.k[iz] )
+                    return hz * normal.w[iz];
+
+                return sample_slow( engine, hz );
+            }
+        } // namespace ziggurat
+    }     // namespace impl
+
+    // Distributions work with any engine above through Engine::rand(). Batch versions give the
+    // same values as successive single calls.
+
+    // Uniform integer in [min, max], Lemire's multiply-shift method. Rejections are rare and
+    // need no division, the threshold is computed once.
+    // https://arxiv.org/abs/1805.10941
+    template<typename Int = int>
+    class uniform_int final
+    {
+    public:
+        static_assert( is_integral_v<Int> && sizeof( Int ) <= sizeof( uint32_t ) );
+
+        constexpr uniform_int( Int min, Int max )
+            : m_min( static_cast<uint32_t>( min ) )
+            , m_range( static_cast<uint32_t>( max ) - static_cast<uint32_t>( min ) + 1 )
+            , m_threshold( m_range ? ( 0u - m_range ) % m_range : 0 )
+        {
+        }
+
+        template<typename Engine>
+        [[nodiscard]] constexpr Int operator()( Engine& engine ) const
+        {
+            return map( engine, engine.rand() );
+        }
+
+        template<typename Engine>
+        constexpr void fill( Engine& engine, span<Int> out ) const
+        {
+            for ( Int& value : out )
+                value = map( engine, engine.rand() );
+        }
+
+    private:
+        uint32_t m_min;
+        uint32_t m_range; // NOTE: 0 means the full 2^32 range
+        uint32_t m_threshold;
+
+        template<typename Engine>
+        [[nodiscard]] constexpr Int map( Engine& engine, uint32_t bits ) const
+        {
+            if ( m_range == 0 )
+                return static_cast<Int>( bits );
+
+            uint64_t product = static_cast<uint64_t>( bits ) * m_range;
+
+            while ( static_cast<uint32_t>( product ) < m_threshold )
+                product = static_cast<uint64_t>( engine.rand() ) * m_range;
+
+            return static_cast<Int>( m_min + static_cast<uint32_t>( product >> 32 ) );
+        }
+    };
+
+    // Uniform float in [min, max) from 24 random bits, one per mantissa bit
+    // NOTE: rounding of min + (max - min) * u may still give max for some ranges
+    class uniform_float final
+    {
+    public:
+        constexpr uniform_float( float min = 0.0f, float max = 1.0f )
+            : m_min( min )
+            , m_scale( ( max - min ) * ( 1.0f / ( 1 << 24 ) ) )
+        {
+        }
+
+        template<typename Engine>
+        [[nodiscard]] constexpr float operator()( Engine& engine ) const
+        {
+            return map( engine.rand() );
+        }
+
+        template<typename Engine>
+        constexpr void fill( Engine& engine, span<float> out ) const
+        {
+            for ( float& value : out )
+                value = map( engine.rand() );
+        }
+
+    private:
+        float m_min;
+        float m_scale;
+
+        [[nodiscard]] constexpr float map( uint32_t bits ) const
+        {
+            return m_min + static_cast<float>( static_cast<int32_t>( bits >> 8 ) ) * m_scale;
+        }
+    };
+
+    // Uniform fixed point value in [min, max], every raw value is equally likely
+    template<typename Int, int F, typename P>
+    class uniform_fix final
+    {
+    public:
+        using fix_type = fix<Int, F, P>;
+
+        constexpr uniform_fix( fix_type min, fix_type max )
+            : m_raw( min.raw(), max.raw() )
+        {
+        }
+
+        template<typename Engine>
+        [[nodiscard]] constexpr fix_type operator()( Engine& engine ) const
+        {
+            return fix_type::from_raw( m_raw( engine ) );
+        }
+
+        template<typename Engine>
+        constexpr void fill( Engine& engine, span<fix_type> out ) const
+        {
+            for ( fix_type& value : out )
+                value = fix_type::from_raw( m_raw( engine ) );
+        }
+
+    private:
+        uniform_int<Int> m_raw;
+    };
+
+    template<typename Int, int F, typename P>
+    uniform_fix( fix<Int, F, P>, fix<Int, F, P> ) -> uniform_fix<Int, F, P>;
+
+    // Normal distribution, ziggurat method with 128 layers. The fast path takes one engine
+    // output, a table lookup and a multiplication.
+    class normal final
+    {
+    public:
+        constexpr normal( float mean = 0.0f, float stddev = 1.0f )
+            : m_mean( mean )
+            , m_stddev( stddev )
+        {
+        }
+
+        template<typename Engine>
+        [[nodiscard]] float operator()( Engine& engine ) const
+        {
+            return m_mean + m_stddev * impl::ziggurat::sample( engine, engine.rand() );
+        }
+
+        template<typename Engine>
+        void fill( Engine& engine, span<float> out ) const
+        {
+            for ( float& value : out )
+                value = m_mean + m_stddev * impl::ziggurat::sample( engine, engine.rand() );
+        }
+
+    private:
+        float m_mean;
+        float m_stddev;
+    };
 } // namespace rtl
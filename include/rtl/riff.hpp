@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/fourcc.hpp>
+#include <rtl/int.hpp>
+#include <rtl/span.hpp>
+
+namespace rtl
+{
+    // Byte order of chunk sizes: RIFF files (WAV, AVI) are little-endian, IFF files (AIFF) and
+    // RIFX files are big-endian
+    enum class riff_endian
+    {
+        little,
+        big
+    };
+
+    namespace impl
+    {
+        [[nodiscard]] constexpr uint32_t load_uint32( const uint8_t* p, riff_endian endian )
+        {
+            return endian == riff_endian::little ? make_fourcc( p[0], p[1], p[2], p[3] )
+                                                 : make_fourcc( p[3], p[2], p[1], p[0] );
+        }
+    } // namespace impl
+
+    struct riff_chunk
+    {
+        uint32_t            id;
+        span<const uint8_t> data;
+
+        // Chunks that contain a form type followed by other chunks
+        [[nodiscard]] constexpr bool is_list() const
+        {
+            return id == make_fourcc( 'R', 'I', 'F', 'F' )
+                   || id == make_fourcc( 'R', 'I', 'F', 'X' )
+                   || id == make_fourcc( 'L', 'I', 'S', 'T' )
+                   || id == make_fourcc( 'F', 'O', 'R', 'M' )
+                   || id == make_fourcc( 'C', 'A', 'T', ' ' );
+        }
+
+        // Form type of a list, e.g. 'WAVE' for the RIFF chunk of a WAV file
+        [[nodiscard]] constexpr uint32_t form() const
+        {
+            return data.size() >= 4 ? load_fourcc( data.data() ) : 0;
+        }
+    };
+
+    // Sibling chunks within a byte span. Only the 8-byte chunk headers are read, the data of
+    // chunks is returned as views into the bytes.
+    // NOTE: a chunk that claims more bytes than there are ends the iteration with its data
+    // clipped, as writers often leave a wrong size in the last chunk
+    class riff_chunks final
+    {
+    public:
+        class iterator final
+        {
+        public:
+            [[nodiscard]] constexpr const riff_chunk& operator*() const
+            {
+                return m_chunk;
+            }
+
+            [[nodiscard]] constexpr const riff_chunk* operator->() const
+            {
+                return &m_chunk;
+            }
+
+            constexpr iterator& operator++()
+            {
+                const uint8_t* next = m_chunk.data.data() + m_chunk.data.size();
+
+                // NOTE: data is padded to an even size
+                if ( ( m_chunk.data.size() & 1 ) && next != m_end )
+                    ++next;
+
+                read( next );
+                return *this;
+            }
+
+            [[nodiscard]] constexpr bool operator==( const iterator& rhs ) const
+            {
+                return m_position == rhs.m_position;
+            }
+
+            [[nodiscard]] constexpr bool operator!=( const iterator& rhs ) const
+            {
+                return !( *this == rhs );
+            }
+
+        private:
+            friend class riff_chunks;
+
+            constexpr iterator( const uint8_t* position, const uint8_t* end, riff_endian endian )
+                : m_end( end )
+                , m_endian( endian )
+            {
+                read( position );
+            }
+
+            constexpr void read( const uint8_t* position )
+            {
+                // NOTE: a trailing partial header is ignored
+                if ( m_end - position < 8 )
+                {
+                    m_position = m_end;
+                    m_chunk = riff_chunk{};
+                    return;
+                }
+
+                const uint32_t size = impl::load_uint32( position + 4, m_endian );
+                const size_t   available = static_cast<size_t>( m_end - position - 8 );
+
+                m_position = position;
+                m_chunk.id = load_fourcc( position );
+                m_chunk.data
+                    = span<const uint8_t>( position + 8, size < available ? size : available );
+            }
+
+            riff_chunk     m_chunk = {};
+            const uint8_t* m_position = nullptr;
+            const uint8_t* m_end;
+            riff_endian    m_endian;
+        };
+
+        constexpr explicit riff_chunks( span<const uint8_t> bytes,
+                                        riff_endian         endian = riff_endian::little )
+            : m_bytes( bytes )
+            , m_endian( endian )
+        {
+        }
+
+        [[nodiscard]] constexpr iterator begin() const
+        {
+            return iterator( m_bytes.data(), m_bytes.data() + m_bytes.size(), m_endian );
+        }
+
+        [[nodiscard]] constexpr iterator end() const
+        {
+            const uint8_t* last = m_bytes.data() + m_bytes.size();
+            return iterator( last, last, m_endian );
+        }
+
+        // Chunks of a list, which follow its form type
+        [[nodiscard]] constexpr riff_chunks children( const riff_chunk& list ) const
+        {
+            return riff_chunks( list.data.size() >= 4 ? list.data.subspan( 4 )
+                                                      : span<const uint8_t>(),
+                                m_endian );
+        }
+
+        // Returns false if there is no chunk with the id among the siblings
+        constexpr bool find( uint32_t id, riff_chunk& result ) const
+        {
+            for ( const riff_chunk& chunk : *this )
+            {
+                if ( chunk.id == id )
+                {
+                    result = chunk;
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+    private:
+        span<const uint8_t> m_bytes;
+        riff_endian         m_endian;
+    };
+} // namespace rtl
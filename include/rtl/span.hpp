@@ -0,0 +1,142 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/array.hpp>
+#include <rtl/int.hpp>
+
+namespace rtl
+{
+    // Non-owning view of a contiguous sequence, dynamic extent only
+    template<typename T>
+    class span final
+    {
+    public:
+        using element_type = T;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator = T*;
+
+        constexpr span()
+            : m_data( nullptr )
+            , m_size( 0 )
+        {
+        }
+
+        constexpr span( T* data, size_t size )
+            : m_data( data )
+            , m_size( size )
+        {
+        }
+
+        template<size_t N>
+        // cppcheck-suppress noExplicitConstructor
+        constexpr span( T ( &data )[N] )
+            : m_data( data )
+            , m_size( N )
+        {
+        }
+
+        template<typename U, unsigned N>
+        // cppcheck-suppress noExplicitConstructor
+        constexpr span( array<U, N>& data )
+            : m_data( data.data() )
+            , m_size( N )
+        {
+        }
+
+        template<typename U, unsigned N>
+        // cppcheck-suppress noExplicitConstructor
+        constexpr span( const array<U, N>& data )
+            : m_data( data.data() )
+            , m_size( N )
+        {
+        }
+
+        // NOTE: span<T> converts to span<const T>
+        template<typename U>
+        // cppcheck-suppress noExplicitConstructor
+        constexpr span( const span<U>& other )
+            : m_data( other.data() )
+            , m_size( other.size() )
+        {
+        }
+
+        [[nodiscard]] constexpr T* data() const
+        {
+            return m_data;
+        }
+
+        [[nodiscard]] constexpr size_t size() const
+        {
+            return m_size;
+        }
+
+        [[nodiscard]] constexpr size_t size_bytes() const
+        {
+            return m_size * sizeof( T );
+        }
+
+        [[nodiscard]] constexpr bool empty() const
+        {
+            return m_size == 0;
+        }
+
+        [[nodiscard]] constexpr T& operator[]( size_t index ) const
+        {
+            return m_data[index];
+        }
+
+        [[nodiscard]] constexpr T* begin() const
+        {
+            return m_data;
+        }
+
+        [[nodiscard]] constexpr T* end() const
+        {
+            return m_data + m_size;
+        }
+
+        [[nodiscard]] constexpr span first( size_t count ) const
+        {
+            return span( m_data, count );
+        }
+
+        [[nodiscard]] constexpr span last( size_t count ) const
+        {
+            return span( m_data + m_size - count, count );
+        }
+
+        [[nodiscard]] constexpr span subspan( size_t offset, size_t count ) const
+        {
+            return span( m_data + offset, count );
+        }
+
+        [[nodiscard]] constexpr span subspan( size_t offset ) const
+        {
+            return span( m_data + offset, m_size - offset );
+        }
+
+    private:
+        T*     m_data;
+        size_t m_size;
+    };
+
+    template<typename T, size_t N>
+    span( T ( & )[N] ) -> span<T>;
+
+    template<typename T, unsigned N>
+    span( array<T, N>& ) -> span<T>;
+
+    template<typename T, unsigned N>
+    span( const array<T, N>& ) -> span<const T>;
+} // namespace rtl
@@ -11,10 +11,373 @@
 #pragma once
 
 #include <rtl/algorithm.hpp>
+#include <rtl/bit.hpp>
 #include <rtl/memory.hpp>
 
+#if RTL_ENABLE_SIMD
+    #include <emmintrin.h>
+#endif
+
 namespace rtl
 {
+    namespace impl
+    {
+        namespace search
+        {
+            // One character per block, usable in constant expressions
+            template<typename T>
+            struct scalar_block
+            {
+                static constexpr size_t lanes = 1;
+
+                [[nodiscard]] static constexpr uint32_t match( const T* p, T value )
+                {
+                    return *p == value ? 1u : 0u;
+                }
+
+                [[nodiscard]] static constexpr int first_lane( uint32_t )
+                {
+                    return 0;
+                }
+
+                [[nodiscard]] static constexpr int last_lane( uint32_t )
+                {
+                    return 0;
+                }
+            };
+
+#if RTL_ENABLE_SIMD
+            // 16 bytes per block, one mask bit per lane
+            template<typename T>
+            struct simd_block
+            {
+                static_assert( sizeof( T ) == 1 || sizeof( T ) == 2 || sizeof( T ) == 4 );
+
+                static constexpr size_t lanes = 16 / sizeof( T );
+
+                [[nodiscard]] static uint32_t match( const T* p, T value )
+                {
+                    const __m128i block
+                        = _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+
+                    if constexpr ( sizeof( T ) == 1 )
+                    {
+                        return static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi8(
+                            block, _mm_set1_epi8( static_cast<char>( value ) ) ) ) );
+                    }
+                    else if constexpr ( sizeof( T ) == 2 )
+                    {
+                        return static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi16(
+                                   block, _mm_set1_epi16( static_cast<short>( value ) ) ) ) )
+                               & 0x5555u;
+                    }
+                    else
+                    {
+                        return static_cast<uint32_t>( _mm_movemask_epi8( _mm_cmpeq_epi32(
+                                   block, _mm_set1_epi32( static_cast<int>( value ) ) ) ) )
+                               & 0x1111u;
+                    }
+                }
+
+                [[nodiscard]] static int first_lane( uint32_t mask )
+                {
+                    return countr_zero( mask ) / static_cast<int>( sizeof( T ) );
+                }
+
+                [[nodiscard]] static int last_lane( uint32_t mask )
+                {
+                    return ( 31 - countl_zero( mask ) ) / static_cast<int>( sizeof( T ) );
+                }
+            };
+#else
+            template<typename T>
+            using simd_block = scalar_block<T>;
+#endif
+
+            template<typename T>
+            [[nodiscard]] constexpr bool equal( const T* a, const T* b, size_t count )
+            {
+                for ( ; count; --count )
+                    if ( *a++ != *b++ )
+                        return false;
+
+                return true;
+            }
+
+            // Maximal suffix of the pattern for the given ordering, see two_way()
+            template<bool Reverse, bool Tilde, typename T>
+            [[nodiscard]] constexpr ptrdiff_t maximal_suffix( const T* x, size_t m, size_t& period )
+            {
+                const auto at = [x, m]( size_t i ) { return Reverse ? x[m - 1 - i] : x[i]; };
+
+                ptrdiff_t ms = -1;
+                size_t    j = 0;
+                size_t    k = 1;
+                period = 1;
+
+                while ( j + k < m )
+                {
+                    const T a = at( j + k );
+                    const T b = at( static_cast<size_t>( ms + static_cast<ptrdiff_t>( k ) ) );
+
+                    if ( Tilde ? a > b : a < b )
+                    {
+                        j += k;
+                        k = 1;
+                        period = j - static_cast<size_t>( ms );
+                    }
+                    else if ( a == b )
+                    {
+                        if ( k != period )
+                        {
+                            ++k;
+                        }
+                        else
+                        {
+                            j += period;
+                            k = 1;
+                        }
+                    }
+                    else
+                    {
+                        ms = static_cast<ptrdiff_t>( j );
+                        j = static_cast<size_t>( ms ) + 1;
+                        k = period = 1;
+                    }
+                }
+
+                return ms;
+            }
+
+            // Two-Way string matching, linear time and constant space.
+            // M. Crochemore, D. Perrin, "Two-way string-matching", J. ACM 38(3), 1991
+            // Returns the first match position in the (optionally reversed) text or npos.
+            template<bool Reverse, typename T>
+            [[nodiscard]] constexpr size_t two_way( const T* y, size_t n, const T* x, size_t m )
+            {
+                const auto xa = [x, m]( ptrdiff_t i ) { return Reverse ? x[m - 1 - i] : x[i]; };
+                const auto ya = [y, n]( size_t i ) { return Reverse ? y[n - 1 - i] : y[i]; };
+
+                const ptrdiff_t sm = static_cast<ptrdiff_t>( m );
+
+                size_t          p = 0;
+                size_t          q = 0;
+                const ptrdiff_t i1 = maximal_suffix<Reverse, false>( x, m, p );
+                const ptrdiff_t i2 = maximal_suffix<Reverse, true>( x, m, q );
+
+                const ptrdiff_t ell = i1 > i2 ? i1 : i2;
+                size_t          period = i1 > i2 ? p : q;
+
+                bool periodic = static_cast<ptrdiff_t>( period ) + ell < sm;
+
+                for ( ptrdiff_t i = 0; periodic && i <= ell; ++i )
+                    periodic = xa( i ) == xa( i + static_cast<ptrdiff_t>( period ) );
+
+                if ( periodic )
+                {
+                    ptrdiff_t memory = -1;
+
+                    for ( size_t j = 0; j + m <= n; )
+                    {
+                        ptrdiff_t i = ( ell > memory ? ell : memory ) + 1;
+
+                        while ( i < sm && xa( i ) == ya( static_cast<size_t>( i ) + j ) )
+                            ++i;
+
+                        if ( i >= sm )
+                        {
+                            i = ell;
+
+                            while ( i > memory && xa( i ) == ya( static_cast<size_t>( i ) + j ) )
+                                --i;
+
+                            if ( i <= memory )
+                                return j;
+
+                            j += period;
+                            memory = sm - static_cast<ptrdiff_t>( period ) - 1;
+                        }
+                        else
+                        {
+                            j += static_cast<size_t>( i - ell );
+                            memory = -1;
+                        }
+                    }
+                }
+                else
+                {
+                    const ptrdiff_t longest = ell + 1 > sm - ell - 1 ? ell + 1 : sm - ell - 1;
+                    period = static_cast<size_t>( longest + 1 );
+
+                    for ( size_t j = 0; j + m <= n; )
+                    {
+                        ptrdiff_t i = ell + 1;
+
+                        while ( i < sm && xa( i ) == ya( static_cast<size_t>( i ) + j ) )
+                            ++i;
+
+                        if ( i >= sm )
+                        {
+                            i = ell;
+
+                            while ( i >= 0 && xa( i ) == ya( static_cast<size_t>( i ) + j ) )
+                                --i;
+
+                            if ( i < 0 )
+                                return j;
+
+                            j += period;
+                        }
+                        else
+                        {
+                            j += static_cast<size_t>( i - ell );
+                        }
+                    }
+                }
+
+                return static_cast<size_t>( -1 );
+            }
+
+            // NOTE: verification of filter candidates is quadratic in the worst case (e.g. "aaa"
+            // in "aaaa...") so after spending more than this on it the search switches to Two-Way
+            [[nodiscard]] constexpr size_t verify_budget( size_t scanned )
+            {
+                return 2 * scanned + 256;
+            }
+
+            // Finds candidates by the first and the last pattern characters a block at a time,
+            // then compares the middle
+            template<typename Block, typename T>
+            [[nodiscard]] constexpr size_t
+            find( const T* str, size_t size, const T* pattern, size_t length, size_t pos )
+            {
+                constexpr size_t npos = static_cast<size_t>( -1 );
+
+                if ( length == 0 )
+                    return pos <= size ? pos : npos;
+
+                if ( pos > size || length > size - pos )
+                    return npos;
+
+                const T      first = pattern[0];
+                const T      last = pattern[length - 1];
+                const size_t end = size - length + 1;
+
+                size_t cost = 0;
+                size_t i = pos;
+
+                for ( ; i + Block::lanes <= end; i += Block::lanes )
+                {
+                    uint32_t mask = Block::match( str + i, first )
+                                    & Block::match( str + i + length - 1, last );
+
+                    for ( ; mask; mask &= mask - 1 )
+                    {
+                        const size_t candidate
+                            = i + static_cast<size_t>( Block::first_lane( mask ) );
+
+                        if ( length <= 2 || equal( str + candidate + 1, pattern + 1, length - 2 ) )
+                            return candidate;
+
+                        cost += length;
+                    }
+
+                    if ( cost > verify_budget( i - pos ) )
+                    {
+                        const size_t found = two_way<false>( str + i, size - i, pattern, length );
+                        return found == npos ? npos : i + found;
+                    }
+                }
+
+                for ( ; i < end; ++i )
+                    if ( str[i] == first && equal( str + i + 1, pattern + 1, length - 1 ) )
+                        return i;
+
+                return npos;
+            }
+
+            // The same as find(), but scans backwards from pos
+            template<typename Block, typename T>
+            [[nodiscard]] constexpr size_t
+            rfind( const T* str, size_t size, const T* pattern, size_t length, size_t pos )
+            {
+                constexpr size_t npos = static_cast<size_t>( -1 );
+
+                if ( length > size )
+                    return npos;
+
+                const size_t start = rtl::min( pos, size - length );
+
+                if ( length == 0 )
+                    return start;
+
+                const T first = pattern[0];
+                const T last = pattern[length - 1];
+
+                size_t cost = 0;
+                size_t i = start + 1; // candidates are in [0, i)
+
+                for ( ; i >= Block::lanes; i -= Block::lanes )
+                {
+                    const size_t base = i - Block::lanes;
+
+                    uint32_t mask = Block::match( str + base, first )
+                                    & Block::match( str + base + length - 1, last );
+
+                    while ( mask )
+                    {
+                        const int    lane = Block::last_lane( mask );
+                        const size_t candidate = base + static_cast<size_t>( lane );
+
+                        if ( length <= 2 || equal( str + candidate + 1, pattern + 1, length - 2 ) )
+                            return candidate;
+
+                        cost += length;
+                        mask &= ~( ~0u << ( lane * static_cast<int>( sizeof( T ) ) ) );
+                    }
+
+                    if ( cost > verify_budget( start + 1 - base ) )
+                    {
+                        const size_t text = base + length - 1;
+                        const size_t found = two_way<true>( str, text, pattern, length );
+                        return found == npos ? npos : text - length - found;
+                    }
+                }
+
+                for ( ; i > 0; --i )
+                    if ( str[i - 1] == first && equal( str + i, pattern + 1, length - 1 ) )
+                        return i - 1;
+
+                return npos;
+            }
+
+            template<typename Block, typename T>
+            [[nodiscard]] constexpr size_t
+            find_first_of( const T* str, size_t size, const T* chars, size_t count, size_t pos )
+            {
+                size_t i = pos;
+
+                for ( ; i + Block::lanes <= size; i += Block::lanes )
+                {
+                    uint32_t mask = 0;
+
+                    for ( size_t k = 0; k < count; ++k )
+                        mask |= Block::match( str + i, chars[k] );
+
+                    if ( mask )
+                        return i + static_cast<size_t>( Block::first_lane( mask ) );
+                }
+
+                for ( ; i < size; ++i )
+                    for ( size_t k = 0; k < count; ++k )
+                        if ( str[i] == chars[k] )
+                            return i;
+
+                return static_cast<size_t>( -1 );
+            }
+        } // namespace search
+    } // namespace impl
+
     // TODO: implement more methods
     template<typename T>
     class basic_string_view final
@@ -62,6 +425,17 @@ namespace rtl
             return m_size == 0;
         }
 
+        [[nodiscard]] constexpr const value_type& operator[]( size_t index ) const
+        {
+            return m_data[index];
+        }
+
+        // NOTE: if pos > size(), then result is undefined
+        [[nodiscard]] constexpr basic_string_view substr( size_t pos, size_t count = npos ) const
+        {
+            return basic_string_view( m_data + pos, rtl::min( count, m_size - pos ) );
+        }
+
         [[nodiscard]] constexpr bool operator==( const basic_string_view<T>& rhs ) const
         {
             if ( size() != rhs.size() )
@@ -77,28 +451,47 @@ namespace rtl
             return true;
         }
 
-        [[nodiscard]] constexpr size_t find( const basic_string_view<T>& what ) const
+        [[nodiscard]] constexpr size_t find( const basic_string_view<T>& what,
+                                             size_t                      pos = 0 ) const
         {
-            // TODO: use Strsafe.h routines?
-            const value_type* str = data();
-            const value_type* str_end = data() + size();
-            const value_type* pattern = what.data();
-            const value_type* pattern_end = what.data() + what.size();
+            if ( rtl::is_constant_evaluated() )
+                return impl::search::find<impl::search::scalar_block<T>>(
+                    data(), size(), what.data(), what.size(), pos );
 
-            for ( ; str < str_end; ++str )
-            {
-                if ( *str == *pattern )
-                {
-                    if ( ++pattern >= pattern_end )
-                        return (size_t)( str - data() );
-                }
-                else
-                {
-                    pattern = what.data();
-                }
-            }
+            return impl::search::find<impl::search::simd_block<T>>(
+                data(), size(), what.data(), what.size(), pos );
+        }
+
+        [[nodiscard]] constexpr size_t find( value_type ch, size_t pos = 0 ) const
+        {
+            return find( basic_string_view<T>( &ch, 1 ), pos );
+        }
+
+        [[nodiscard]] constexpr size_t rfind( const basic_string_view<T>& what,
+                                              size_t                      pos = npos ) const
+        {
+            if ( rtl::is_constant_evaluated() )
+                return impl::search::rfind<impl::search::scalar_block<T>>(
+                    data(), size(), what.data(), what.size(), pos );
+
+            return impl::search::rfind<impl::search::simd_block<T>>(
+                data(), size(), what.data(), what.size(), pos );
+        }
+
+        [[nodiscard]] constexpr size_t rfind( value_type ch, size_t pos = npos ) const
+        {
+            return rfind( basic_string_view<T>( &ch, 1 ), pos );
+        }
 
-            return npos;
+        [[nodiscard]] constexpr size_t find_first_of( const basic_string_view<T>& chars,
+                                                      size_t                      pos = 0 ) const
+        {
+            if ( rtl::is_constant_evaluated() )
+                return impl::search::find_first_of<impl::search::scalar_block<T>>(
+                    data(), size(), chars.data(), chars.size(), pos );
+
+            return impl::search::find_first_of<impl::search::simd_block<T>>(
+                data(), size(), chars.data(), chars.size(), pos );
         }
 
     private:
@@ -123,7 +516,7 @@ namespace rtl
 
         constexpr basic_string( size_t size, value_type ch )
             : m_data( new value_type[size + 1] )
-            , m_size( size + 1 )
+            , m_size( size )
         {
             rtl::fill_n( m_data.get(), m_size, ch );
             m_data[size] = 0;
@@ -136,14 +529,8 @@ namespace rtl
             : m_data( new value_type[view.size() + 1] )
             , m_size( view.size() )
         {
-            // TODO: use Strsafe.h routines?
-            value_type*       dst = m_data.get();
-            const value_type* src = view.data();
-
-            for ( size_t i = 0; i < view.size(); ++i )
-                *dst++ = *src++;
-
-            *dst = 0;
+            rtl::copy_n( view.data(), view.size(), m_data.get() );
+            m_data[m_size] = 0;
         }
 
         [[nodiscard]] constexpr const value_type* data() const
@@ -171,32 +558,22 @@ namespace rtl
             return m_size == 0;
         }
 
-        // TODO: basic_string_view::find
-        [[nodiscard]] constexpr size_t rfind( const basic_string_view<T>& what ) const
+        [[nodiscard]] constexpr size_t rfind( const basic_string_view<T>& what,
+                                              size_t                      pos = npos ) const
         {
-            // TODO: use Strsafe.h routines?
-            const value_type* str = data() + size() - 1;
-            const value_type* pattern = what.data() + what.size() - 1;
-
-            for ( ; str >= data(); --str )
-            {
-                if ( *str == *pattern )
-                {
-                    if ( --pattern < what.data() )
-                        return (size_t)( str - data() );
-                }
-                else
-                {
-                    pattern = what.data() + what.size() - 1;
-                }
-            }
+            return basic_string_view<value_type>( *this ).rfind( what, pos );
+        }
 
-            return npos;
+        [[nodiscard]] constexpr size_t find( const basic_string_view<T>& what,
+                                             size_t                      pos = 0 ) const
+        {
+            return basic_string_view<value_type>( *this ).find( what, pos );
         }
 
-        [[nodiscard]] constexpr size_t find( const basic_string_view<T>& what ) const
+        [[nodiscard]] constexpr size_t find_first_of( const basic_string_view<T>& chars,
+                                                      size_t                      pos = 0 ) const
         {
-            return rtl::basic_string_view<value_type>( *this ).find( what );
+            return basic_string_view<value_type>( *this ).find_first_of( chars, pos );
         }
 
         [[nodiscard]] constexpr basic_string substr( size_t from, size_t to = npos ) const
@@ -210,23 +587,12 @@ namespace rtl
 
         [[nodiscard]] constexpr basic_string operator+( const basic_string_view<T>& rhs ) const
         {
-            // TODO: use Strsafe.h routines?
             basic_string<value_type> result;
             result.m_size = size() + rhs.size();
             result.m_data.reset( new value_type[result.m_size + 1] );
 
-            const value_type* src = data();
-            value_type*       dst = result.m_data.get();
-
-            for ( size_t i = 0; i < size(); ++i )
-                *dst++ = *src++;
-
-            src = rhs.data();
-            dst = result.m_data.get() + size();
-
-            for ( size_t i = 0; i < rhs.size(); ++i )
-                *dst++ = *src++;
-
+            value_type* dst = rtl::copy_n( data(), size(), result.m_data.get() );
+            dst = rtl::copy_n( rhs.data(), rhs.size(), dst );
             *dst = 0;
 
             return result;
@@ -280,11 +646,8 @@ namespace rtl
             : m_data( new value_type[other.m_size + 1] )
             , m_size( other.m_size )
         {
-            const value_type* src = other.data();
-            value_type*       dst = m_data.get();
-
-            for ( size_t i = 0; i < size(); ++i )
-                *dst++ = *src++;
+            rtl::copy_n( other.data(), m_size, m_data.get() );
+            m_data[m_size] = 0;
         }
 
         // cppcheck-suppress operatorEq
@@ -295,11 +658,8 @@ namespace rtl
                 m_data.reset( new value_type[other.m_size + 1] );
                 m_size = other.m_size;
 
-                const value_type* src = other.data();
-                value_type*       dst = m_data.get();
-
-                for ( size_t i = 0; i < size(); ++i )
-                    *dst++ = *src++;
+                rtl::copy_n( other.data(), m_size, m_data.get() );
+                m_data[m_size] = 0;
             }
 
             return *this;
@@ -11,13 +11,213 @@
 #pragma once
 
 #include <rtl/algorithm.hpp>
+#include <rtl/hash.hpp>
 #include <rtl/int.hpp>
+#include <rtl/span.hpp>
 #include <rtl/string.hpp>
+#include <rtl/utf.hpp>
+
+#include <rtl/sys/debug.hpp>
+
+struct _WIN32_FIND_DATAW;
 
 namespace rtl
 {
     namespace filesystem
     {
+        namespace impl
+        {
+            template<typename T>
+            [[nodiscard]] constexpr bool is_separator( T ch )
+            {
+                return ch == T( '/' ) || ch == T( '\\' );
+            }
+        } // namespace impl
+
+        // Non-owning path, decomposes it without allocations. Both '/' and '\\' are separators.
+        template<typename T>
+        class basic_path_view final
+        {
+        public:
+            using view_type = basic_string_view<T>;
+
+            // Iterates over non-empty segments, separators are skipped
+            class iterator final
+            {
+            public:
+                constexpr basic_path_view operator*() const
+                {
+                    return m_segment;
+                }
+
+                constexpr iterator& operator++()
+                {
+                    advance( m_segment.data() + m_segment.size() );
+                    return *this;
+                }
+
+                constexpr bool operator==( const iterator& rhs ) const
+                {
+                    return m_segment.data() == rhs.m_segment.data();
+                }
+
+                constexpr bool operator!=( const iterator& rhs ) const
+                {
+                    return !( *this == rhs );
+                }
+
+            private:
+                friend class basic_path_view;
+
+                constexpr iterator( const T* first, const T* last )
+                    : m_end( last )
+                {
+                    advance( first );
+                }
+
+                constexpr void advance( const T* first )
+                {
+                    while ( first != m_end && impl::is_separator( *first ) )
+                        ++first;
+
+                    const T* last = first;
+                    while ( last != m_end && !impl::is_separator( *last ) )
+                        ++last;
+
+                    m_segment = view_type( first, static_cast<size_t>( last - first ) );
+                }
+
+                view_type m_segment;
+                const T*  m_end;
+            };
+
+            constexpr basic_path_view() = default;
+
+            // cppcheck-suppress noExplicitConstructor
+            constexpr basic_path_view( const view_type& p )
+                : m_path( p )
+            {
+            }
+
+            // cppcheck-suppress noExplicitConstructor
+            constexpr basic_path_view( const T* p )
+                : m_path( p )
+            {
+            }
+
+            [[nodiscard]] constexpr const view_type& native() const
+            {
+                return m_path;
+            }
+
+            [[nodiscard]] constexpr bool empty() const
+            {
+                return m_path.empty();
+            }
+
+            // "dir/name.ext" -> "name.ext", "dir/" -> ""
+            [[nodiscard]] constexpr basic_path_view filename() const
+            {
+                return m_path.substr( filename_pos() );
+            }
+
+            // "dir/name.ext" -> "dir", "/name" -> "/", "C:/name" -> "C:/"
+            [[nodiscard]] constexpr basic_path_view parent_path() const
+            {
+                const size_t pos = filename_pos();
+
+                size_t length = pos;
+                while ( length > 1 && impl::is_separator( m_path[length - 1] ) )
+                    --length;
+
+                if ( length == 2 && pos > 2 && m_path[1] == T( ':' ) )
+                    length = 3;
+
+                return m_path.substr( 0, length );
+            }
+
+            // "name.ext" -> "name", ".name" -> ".name"
+            [[nodiscard]] constexpr basic_path_view stem() const
+            {
+                const view_type name = filename().native();
+                return name.substr( 0, extension_pos( name ) );
+            }
+
+            // "name.ext" -> ".ext", ".name" -> ""
+            [[nodiscard]] constexpr basic_path_view extension() const
+            {
+                const view_type name = filename().native();
+                return name.substr( extension_pos( name ) );
+            }
+
+            [[nodiscard]] constexpr iterator begin() const
+            {
+                return iterator( m_path.data(), m_path.data() + m_path.size() );
+            }
+
+            [[nodiscard]] constexpr iterator end() const
+            {
+                return iterator( m_path.data() + m_path.size(), m_path.data() + m_path.size() );
+            }
+
+            [[nodiscard]] constexpr bool operator==( const basic_path_view& rhs ) const
+            {
+                return m_path == rhs.m_path;
+            }
+
+            [[nodiscard]] constexpr bool operator!=( const basic_path_view& rhs ) const
+            {
+                return !( *this == rhs );
+            }
+
+            // Joins with a single allocation, a separator is inserted only if none is present
+            [[nodiscard]] friend basic_string<T> operator/( const basic_path_view& lhs,
+                                                            const basic_path_view& rhs )
+            {
+                const view_type& l = lhs.m_path;
+                const view_type& r = rhs.m_path;
+
+                const size_t separator = !l.empty() && !r.empty()
+                                         && !impl::is_separator( l[l.size() - 1] )
+                                         && !impl::is_separator( r[0] );
+
+                basic_string<T> result( l.size() + separator + r.size(), T( '/' ) );
+                rtl::copy_n( r.data(),
+                             r.size(),
+                             rtl::copy_n( l.data(), l.size(), result.data() ) + separator );
+                return result;
+            }
+
+        private:
+            [[nodiscard]] constexpr size_t filename_pos() const
+            {
+                size_t pos = m_path.size();
+                while ( pos > 0 && !impl::is_separator( m_path[pos - 1] ) )
+                    --pos;
+
+                return pos;
+            }
+
+            // NOTE: "." and ".." have no extension, as well as names starting with a dot
+            [[nodiscard]] static constexpr size_t extension_pos( const view_type& name )
+            {
+                size_t pos = name.size();
+                while ( pos > 1 && name[pos - 1] != T( '.' ) )
+                    --pos;
+
+                const bool dot_dot = name.size() == 2 && name[0] == T( '.' ) && name[1] == T( '.' );
+                if ( pos <= 1 || dot_dot )
+                    return name.size();
+
+                return pos - 1;
+            }
+
+            view_type m_path;
+        };
+
+        using path_view = basic_path_view<wchar_t>;
+        using u8path_view = basic_path_view<char>;
+
         // TODO: Implement a more complete analogue of std::filesystem
         class path final
         {
@@ -30,6 +230,17 @@ namespace rtl
             {
             }
 
+            explicit path( rtl::wstring&& p )
+                : m_path( rtl::move( p ) )
+            {
+            }
+
+            // UTF-8 encoded path
+            explicit path( const string_view& p )
+                : m_path( utf8_to_wide( p ) )
+            {
+            }
+
             const wchar_t* c_str() const
             {
                 return m_path.c_str();
@@ -40,9 +251,24 @@ namespace rtl
                 return m_path;
             }
 
+            rtl::string u8string() const
+            {
+                return wide_to_utf8( m_path );
+            }
+
+            path_view view() const
+            {
+                return path_view( m_path );
+            }
+
             path extension() const
             {
-                return path( m_path.substr( m_path.rfind( L"." ) ) );
+                return path( view().extension().native() );
+            }
+
+            path operator/( const path_view& rhs ) const
+            {
+                return path( view() / rhs );
             }
 
             bool operator==( const path& rhs ) const
@@ -66,6 +292,9 @@ namespace rtl
             bool is_regular_file() const;
             bool is_directory() const;
 
+            // NOTE: true for any reparse point, junctions included
+            bool is_symlink() const;
+
             bool exists() const
             {
                 return m_attributes != 0;
@@ -76,6 +305,12 @@ namespace rtl
                 return m_file_size;
             }
 
+            // In 100-nanosecond intervals since January 1, 1601 (UTC)
+            uint64_t last_write_time() const
+            {
+                return m_last_write_time;
+            }
+
             const path& path() const
             {
                 return m_path;
@@ -89,10 +324,13 @@ namespace rtl
             filesystem::path m_path;
             uint32_t         m_pad1;
             uintmax_t        m_file_size = 0;
+            uint64_t         m_last_write_time = 0;
             uint32_t         m_attributes = 0;
             uint32_t         m_pad2;
         };
 
+        // Lists a directory, skipping "." and "..". Entry paths are prefixed with the
+        // directory path.
         class directory_iterator final
         {
         public:
@@ -115,12 +353,666 @@ namespace rtl
             directory_iterator& operator=( directory_iterator&& other );
 
         private:
+            // Fills the entry straight from the find data, no extra attribute query
+            void assign( const _WIN32_FIND_DATAW& data );
+
             directory_entry m_entry;
+            rtl::wstring    m_directory;
             void*           m_handle;
             uint32_t        m_pad1;
         };
 
+        // Depth-first listing of a directory tree. Symlinks and junctions are listed but not
+        // followed.
+        class recursive_directory_iterator final
+        {
+        public:
+            recursive_directory_iterator() = default;
+
+            explicit recursive_directory_iterator( const path& path );
+            ~recursive_directory_iterator();
+
+            recursive_directory_iterator& operator++();
+
+            const directory_entry& operator*() const;
+
+            bool operator==( const recursive_directory_iterator& rhs ) const;
+            bool operator!=( const recursive_directory_iterator& rhs ) const;
+
+            recursive_directory_iterator( const recursive_directory_iterator& ) = delete;
+            recursive_directory_iterator& operator=( const recursive_directory_iterator& )
+                = delete;
+
+            recursive_directory_iterator( recursive_directory_iterator&& other );
+            recursive_directory_iterator& operator=( recursive_directory_iterator&& other );
+
+            // Depth of the current entry, 0 for entries of the root directory
+            int depth() const
+            {
+                return m_depth;
+            }
+
+            // Do not descend into the current entry on the next increment
+            void disable_recursion_pending()
+            {
+                m_recursion_pending = false;
+            }
+
+            // Leaves the current directory and moves to the next entry of its parent
+            void pop();
+
+        private:
+            struct level;
+
+            void advance();
+            void drop_level();
+
+            level* m_top = nullptr;
+            int    m_depth = 0;
+            bool   m_recursion_pending = true;
+        };
+
+        // Entry passed to a walk visitor, backed by the enumeration data without any allocation
+        struct walk_entry
+        {
+            wstring_view directory; // ends with a separator
+            wstring_view name;
+            uintmax_t    file_size;
+            uint32_t     attributes;
+            int          depth;
+
+            bool is_directory() const;
+
+            filesystem::path path() const
+            {
+                return filesystem::path( path_view( directory ) / name );
+            }
+        };
+
+        struct walk_options
+        {
+            // Only files with this extension (".png", ASCII case-insensitive) are visited
+            wstring_view extension;
+
+            // Directories are visited too, before their content is listed
+            bool directories = false;
+
+            // 0 means one thread per processor
+            int threads = 0;
+        };
+
+        using walk_function = void( const walk_entry& entry, void* context );
+
+        // Visits all files of a tree in parallel. Every subdirectory becomes a task that idle
+        // threads steal, so the visitor is called concurrently and in no particular order.
+        // Symlinks and junctions are not followed.
+        void walk( const path&         root,
+                   walk_function*      visitor,
+                   void*               context,
+                   const walk_options& options = walk_options() );
+
+        template<typename Visitor>
+        void walk( const path&         root,
+                   Visitor&            visitor,
+                   const walk_options& options = walk_options() )
+        {
+            walk(
+                root,
+                []( const walk_entry& entry, void* context )
+                {
+                    ( *static_cast<Visitor*>( context ) )( entry );
+                },
+                &visitor,
+                options );
+        }
+
+        enum class watch_action
+        {
+            created,
+            modified,
+            removed,
+            renamed,
+            overflow, // changes were lost, the tree must be rescanned
+        };
+
+        struct watch_event
+        {
+            watch_action action;
+            wstring_view name;     // relative to the watched directory
+            wstring_view old_name; // renamed only
+        };
+
+        using watch_function = void( const watch_event& event, void* context );
+
+        // Reports changes in a directory tree. The system collects them into a buffer between
+        // polls, so nothing is spent while nothing changes. Each poll delivers one batch, in
+        // which repeated changes of the same name are coalesced.
+        class watcher final
+        {
+        public:
+            static constexpr size_t default_buffer_size = 64 * 1024;
+
+            watcher() = default;
+
+            explicit watcher( const path& directory,
+                              bool        recursive = true,
+                              size_t      buffer_size = default_buffer_size );
+            ~watcher();
+
+            // NOTE: not movable, the pending request refers to the object
+            watcher( const watcher& ) = delete;
+            watcher& operator=( const watcher& ) = delete;
+
+            bool open( const path& directory,
+                       bool        recursive = true,
+                       size_t      buffer_size = default_buffer_size );
+            void close();
+
+            // Delivers the next batch of changes, waits up to timeout_ms for it. Event names
+            // are only valid during the call. Returns the number of events delivered.
+            int poll( watch_function* callback, void* context, uint32_t timeout_ms = 0 );
+
+            template<typename Visitor>
+            int poll( Visitor& visitor, uint32_t timeout_ms = 0 )
+            {
+                return poll(
+                    []( const watch_event& event, void* context )
+                    {
+                        ( *static_cast<Visitor*>( context ) )( event );
+                    },
+                    &visitor,
+                    timeout_ms );
+            }
+
+            // Event object signaled once a batch is ready, for an application loop that waits
+            // on it along with messages
+            void* handle() const;
+
+            bool is_open() const
+            {
+                return m_state != nullptr;
+            }
+
+            // The directory can not be watched anymore, e.g. it was removed
+            bool failed() const
+            {
+                return m_failed;
+            }
+
+        private:
+            struct state;
+
+            void issue();
+
+            state* m_state = nullptr;
+            bool   m_failed = false;
+        };
+
         size_t read_file_content( const wchar_t* name, void* p, size_t size );
 
+        // Whole file mapped into the address space, pages are read on first access.
+        // NOTE: files that do not fit into size_t are not mapped
+        class mapped_file final
+        {
+        public:
+            enum class mode
+            {
+                read_only,
+                read_write
+            };
+
+            // Access pattern hint for the cache manager, given when the file is opened
+            enum class access
+            {
+                normal,
+                sequential,
+                random
+            };
+
+            // What other handles may do to the file while it is open
+            // NOTE: whatever the share mode, Windows does not delete, rename over or truncate a
+            // file while a view of it is mapped
+            enum class share
+            {
+                read, // only read it
+                all   // also write it in place, or delete and rename it once it is unmapped
+            };
+
+            mapped_file() = default;
+
+            explicit mapped_file( const path& p,
+                                  mode        m = mode::read_only,
+                                  access      a = access::normal,
+                                  share       s = share::read );
+            ~mapped_file();
+
+            mapped_file( const mapped_file& ) = delete;
+            mapped_file& operator=( const mapped_file& ) = delete;
+
+            mapped_file( mapped_file&& other );
+            mapped_file& operator=( mapped_file&& other );
+
+            bool open( const path& p,
+                       mode        m = mode::read_only,
+                       access      a = access::normal,
+                       share       s = share::read );
+            void close();
+
+            // Asks the system to read the pages of the range in ahead of use
+            void prefetch( size_t offset, size_t size ) const;
+
+            void prefetch() const
+            {
+                prefetch( 0, m_size );
+            }
+
+            // Writes dirty pages of a read_write mapping back to the file
+            bool flush();
+
+            bool is_open() const
+            {
+                return m_file != nullptr;
+            }
+
+            size_t size() const
+            {
+                return m_size;
+            }
+
+            const uint8_t* data() const
+            {
+                return m_data;
+            }
+
+            // NOTE: only valid for read_write mappings
+            uint8_t* writable_data()
+            {
+                RTL_ASSERT( m_mode == mode::read_write );
+                return m_data;
+            }
+
+            span<const uint8_t> bytes() const
+            {
+                return span<const uint8_t>( m_data, m_size );
+            }
+
+            string_view view() const
+            {
+                return string_view( reinterpret_cast<const char*>( m_data ), m_size );
+            }
+
+        private:
+            void*    m_file = nullptr;
+            void*    m_mapping = nullptr;
+            uint8_t* m_data = nullptr;
+            size_t   m_size = 0;
+            mode     m_mode = mode::read_only;
+        };
+
+        // Reads a file front to back in fixed-size chunks. The following chunks are read with
+        // overlapped I/O while the caller consumes the current one.
+        class stream_reader final
+        {
+        public:
+            static constexpr size_t default_chunk_size = 256 * 1024;
+            static constexpr int    max_buffers = 8;
+
+            stream_reader() = default;
+
+            explicit stream_reader( const path& p,
+                                    size_t      chunk_size = default_chunk_size,
+                                    int         buffers = 2 );
+            ~stream_reader();
+
+            // NOTE: not movable, pending reads refer to the object
+            stream_reader( const stream_reader& ) = delete;
+            stream_reader& operator=( const stream_reader& ) = delete;
+
+            bool open( const path& p, size_t chunk_size = default_chunk_size, int buffers = 2 );
+            void close();
+
+            // Returns the next chunk, which stays valid until the following call.
+            // Only the last chunk may be shorter than chunk_size. An empty span means end of
+            // file or a read error, see failed().
+            span<const uint8_t> next();
+
+            bool is_open() const
+            {
+                return m_file != nullptr;
+            }
+
+            bool failed() const
+            {
+                return m_failed;
+            }
+
+            uint64_t file_size() const
+            {
+                return m_file_size;
+            }
+
+            // File offset of the chunk returned by the last call to next()
+            uint64_t position() const
+            {
+                return m_position;
+            }
+
+        private:
+            struct request;
+
+            void issue( request& r );
+
+            void*    m_file = nullptr;
+            request* m_requests = nullptr;
+            uint8_t* m_memory = nullptr;
+            uint64_t m_file_size = 0;
+            uint64_t m_read_offset = 0;
+            uint64_t m_position = 0;
+            size_t   m_chunk_size = 0;
+            int      m_buffers = 0;
+            int      m_head = 0;
+            int      m_consumed = -1;
+            bool     m_failed = false;
+        };
+
+        // Sequential file writer with a user-space buffer, so the system is called once per
+        // filled buffer rather than once per record. In atomic mode the content goes to a
+        // temporary file next to the target, which replaces the target only on commit().
+        class file_writer final
+        {
+        public:
+            enum class mode
+            {
+                truncate,
+                atomic
+            };
+
+            static constexpr size_t default_buffer_size = 64 * 1024;
+
+            file_writer() = default;
+
+            explicit file_writer( const path& p,
+                                  mode        m = mode::truncate,
+                                  size_t      buffer_size = default_buffer_size );
+
+            // NOTE: an atomic write that was not committed is discarded
+            ~file_writer();
+
+            file_writer( const file_writer& ) = delete;
+            file_writer& operator=( const file_writer& ) = delete;
+
+            bool open( const path& p,
+                       mode        m = mode::truncate,
+                       size_t      buffer_size = default_buffer_size );
+
+            // Flushes and closes the file, or discards the temporary file in atomic mode
+            void close();
+
+            // Flushes, syncs in atomic mode, closes, and then replaces the target in atomic mode
+            bool commit();
+
+            bool write( const void* data, size_t size );
+
+            bool write( span<const uint8_t> data )
+            {
+                return write( data.data(), data.size() );
+            }
+
+            // Gather write: small pieces are coalesced in the buffer, whole buffers of large
+            // pieces are written directly
+            bool write( span<const span<const uint8_t>> pieces );
+
+            // Hands the buffered data over to the system
+            bool flush();
+
+            // Flushes and waits until the data reaches the disk
+            bool sync();
+
+            bool is_open() const
+            {
+                return m_file != nullptr;
+            }
+
+            // Any failure is sticky, the following writes are ignored
+            bool failed() const
+            {
+                return m_failed;
+            }
+
+            // Bytes written so far, buffered ones included
+            uint64_t size() const
+            {
+                return m_size;
+            }
+
+        private:
+            bool write_file( const void* data, size_t size );
+            bool finish( bool keep );
+
+            filesystem::path m_target;
+            filesystem::path m_temporary;
+            void*            m_file = nullptr;
+            uint8_t*         m_buffer = nullptr;
+            size_t           m_capacity = 0;
+            size_t           m_used = 0;
+            uint64_t         m_size = 0;
+            mode             m_mode = mode::truncate;
+            bool             m_failed = false;
+        };
+
+        // Contents of files keyed by path, within a byte budget. Every lookup checks the last
+        // write time and size of the file, so a changed file is read again. Least recently used
+        // entries are evicted first. Files of at least map_threshold bytes are mapped instead
+        // of read.
+        // NOTE: mapped entries keep their files open and mapped. Other programs may write them
+        // in place, but deleting, renaming over or truncating such a file fails until its entry
+        // is evicted or cleared.
+        class file_cache final
+        {
+        public:
+            static constexpr size_t default_map_threshold = 64 * 1024;
+
+            struct statistics
+            {
+                uint32_t hits;
+                uint32_t misses;
+                uint32_t evictions;
+            };
+
+            explicit file_cache( size_t budget, size_t map_threshold = default_map_threshold );
+            ~file_cache();
+
+            file_cache( const file_cache& ) = delete;
+            file_cache& operator=( const file_cache& ) = delete;
+
+            // Returns the file content, which stays valid until the following call to get()
+            // or clear(). An empty span means an empty, missing or unreadable file.
+            // NOTE: a file larger than the budget is still returned, evicting everything else
+            span<const uint8_t> get( const path& p );
+
+            void clear();
+
+            // Bytes of file content held
+            size_t size() const
+            {
+                return m_size;
+            }
+
+            size_t count() const
+            {
+                return m_count;
+            }
+
+            const statistics& stats() const
+            {
+                return m_stats;
+            }
+
+        private:
+            struct entry;
+
+            entry* find( const path& p, size_t hash ) const;
+            entry* load( const directory_entry& file, size_t hash );
+            void   link( entry* e );
+            void   unlink( entry* e );
+            void   evict( const entry* keep );
+            void   rehash( size_t bucket_count );
+
+            entry**    m_buckets = nullptr;
+            size_t     m_bucket_count = 0;
+            entry*     m_newest = nullptr;
+            entry*     m_oldest = nullptr;
+            size_t     m_budget;
+            size_t     m_map_threshold;
+            size_t     m_size = 0;
+            size_t     m_count = 0;
+            statistics m_stats = {};
+        };
+
+        class io_request;
+
+        using io_callback = void( io_request& request, void* context );
+
+        // One asynchronous read or write. Owned by the caller and identified by its address,
+        // so it must stay in place until the request completes.
+        class io_request final
+        {
+        public:
+            io_request() = default;
+
+            io_request( const io_request& ) = delete;
+            io_request& operator=( const io_request& ) = delete;
+
+            bool pending() const
+            {
+                return m_pending;
+            }
+
+            // Bytes transferred, valid once the request is complete
+            size_t bytes() const
+            {
+                return m_bytes;
+            }
+
+            // System error code, 0 on success
+            uint32_t error() const
+            {
+                return m_error;
+            }
+
+        private:
+            friend class async_file;
+            friend class io_queue;
+
+            // NOTE: storage of the system OVERLAPPED structure, must be the first member
+            alignas( void* ) uint8_t m_overlapped[sizeof( void* ) * 4 + 8];
+
+            void*        m_file = nullptr;
+            io_callback* m_callback = nullptr;
+            void*        m_context = nullptr;
+            uint32_t     m_bytes = 0;
+            uint32_t     m_error = 0;
+            bool         m_pending = false;
+        };
+
+        // Completion queue of async_file requests (an I/O completion port). Any number of files
+        // and requests share one queue; completions are delivered by poll(), typically called
+        // from the application loop.
+        // NOTE: submit and poll from one thread
+        class io_queue final
+        {
+        public:
+            io_queue();
+            ~io_queue();
+
+            io_queue( const io_queue& ) = delete;
+            io_queue& operator=( const io_queue& ) = delete;
+
+            // Completes a batch of finished requests and calls their callbacks, waits up to
+            // timeout_ms for the first one. Returns the number of completed requests.
+            int poll( uint32_t timeout_ms = 0 );
+
+            // Polls until no request is pending
+            void wait();
+
+            int pending() const
+            {
+                return m_pending;
+            }
+
+        private:
+            friend class async_file;
+
+            void* m_port;
+            int   m_pending = 0;
+        };
+
+        // File for asynchronous positional reads and writes through an io_queue
+        class async_file final
+        {
+        public:
+            enum class mode
+            {
+                read,       // existing file
+                write,      // created or truncated
+                read_write, // opened or created
+            };
+
+            async_file() = default;
+
+            async_file( io_queue& queue, const path& p, mode m = mode::read );
+            ~async_file();
+
+            async_file( const async_file& ) = delete;
+            async_file& operator=( const async_file& ) = delete;
+
+            bool open( io_queue& queue, const path& p, mode m = mode::read );
+
+            // Pending requests are cancelled, their completions still arrive through the queue
+            void close();
+
+            bool is_open() const
+            {
+                return m_file != nullptr;
+            }
+
+            uint64_t size() const;
+
+            // Start a transfer, the buffer must stay valid until completion. Returns false if
+            // the request failed to start, see request.error().
+            bool read_at( io_request&  request,
+                          uint64_t     offset,
+                          void*        buffer,
+                          size_t       size,
+                          io_callback* callback = nullptr,
+                          void*        context = nullptr );
+
+            bool write_at( io_request&  request,
+                           uint64_t     offset,
+                           const void*  buffer,
+                           size_t       size,
+                           io_callback* callback = nullptr,
+                           void*        context = nullptr );
+
+        private:
+            bool submit( io_request& request,
+                         uint64_t    offset,
+                         void*       buffer,
+                         size_t      size,
+                         bool        write );
+
+            io_queue* m_queue = nullptr;
+            void*     m_file = nullptr;
+        };
+
     } // namespace filesystem
+
+    template<>
+    struct hash<filesystem::path>
+    {
+        [[nodiscard]] size_t operator()( const filesystem::path& p ) const
+        {
+            return hash<wstring>()( p.wstring() );
+        }
+    };
 } // namespace rtl
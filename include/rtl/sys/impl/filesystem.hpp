@@ -41,12 +41,18 @@ namespace rtl
             return m_attributes & FILE_ATTRIBUTE_DIRECTORY;
         }
 
+        bool directory_entry::is_symlink() const
+        {
+            return m_attributes & FILE_ATTRIBUTE_REPARSE_POINT;
+        }
+
         void directory_entry::refresh()
         {
             WIN32_FILE_ATTRIBUTE_DATA data;
 
             m_attributes = 0;
             m_file_size = 0;
+            m_last_write_time = 0;
 
             const BOOL result
                 = ::GetFileAttributesExW( m_path.c_str(), GetFileExInfoStandard, &data );
@@ -56,6 +62,10 @@ namespace rtl
                 m_file_size = ( ( static_cast<uintmax_t>( data.nFileSizeHigh ) << 32ull ) )
                               | data.nFileSizeLow;
 
+                m_last_write_time
+                    = ( static_cast<uint64_t>( data.ftLastWriteTime.dwHighDateTime ) << 32 )
+                      | data.ftLastWriteTime.dwLowDateTime;
+
                 m_attributes = data.dwFileAttributes;
             }
         }
@@ -70,19 +80,46 @@ namespace rtl
         {
         }
 
+        namespace impl
+        {
+            [[nodiscard]] inline bool is_dot_or_dot_dot( const wchar_t* name )
+            {
+                return name[0] == L'.' && ( name[1] == 0 || ( name[1] == L'.' && name[2] == 0 ) );
+            }
+
+            // Directory path as a prefix for its entries
+            [[nodiscard]] inline wstring with_separator( const wstring& directory )
+            {
+                const bool has_separator
+                    = !directory.empty()
+                      && ( directory.data()[directory.size() - 1] == L'/'
+                           || directory.data()[directory.size() - 1] == L'\\' );
+
+                return has_separator ? directory : directory + L"/";
+            }
+        } // namespace impl
+
         directory_iterator::directory_iterator( const filesystem::path& path )
+            : m_directory( impl::with_separator( path.wstring() ) )
         {
+
             WIN32_FIND_DATAW data;
 
-            m_handle = ::FindFirstFileExW( ( path.wstring() + L"/*" ).c_str(),
+            // NOTE: basic info skips the short name, large fetch batches entries per kernel call
+            m_handle = ::FindFirstFileExW( ( m_directory + L"*" ).c_str(),
                                            FindExInfoBasic,
                                            &data,
                                            FindExSearchNameMatch,
                                            nullptr,
-                                           0 );
+                                           FIND_FIRST_EX_LARGE_FETCH );
 
             if ( m_handle != INVALID_HANDLE_VALUE )
-                m_entry = directory_entry( filesystem::path( data.cFileName ) );
+            {
+                if ( impl::is_dot_or_dot_dot( data.cFileName ) )
+                    operator++();
+                else
+                    assign( data );
+            }
         }
 
         directory_iterator::~directory_iterator()
@@ -98,27 +135,44 @@ namespace rtl
         {
             WIN32_FIND_DATAW data;
 
-            BOOL result = ::FindNextFileW( m_handle, &data );
-
-            if ( !result )
+            for ( ;; )
             {
-                RTL_WINAPI_CHECK( ::GetLastError() == ERROR_NO_MORE_FILES );
+                BOOL result = ::FindNextFileW( m_handle, &data );
 
-                result = ::FindClose( m_handle );
-                RTL_WINAPI_CHECK( result );
+                if ( !result )
+                {
+                    RTL_WINAPI_CHECK( ::GetLastError() == ERROR_NO_MORE_FILES );
 
-                m_handle = INVALID_HANDLE_VALUE;
+                    result = ::FindClose( m_handle );
+                    RTL_WINAPI_CHECK( result );
 
-                m_entry = directory_entry();
-            }
-            else
-            {
-                m_entry = directory_entry( path( data.cFileName ) );
+                    m_handle = INVALID_HANDLE_VALUE;
+
+                    m_entry = directory_entry();
+                    break;
+                }
+
+                if ( !impl::is_dot_or_dot_dot( data.cFileName ) )
+                {
+                    assign( data );
+                    break;
+                }
             }
 
             return *this;
         }
 
+        void directory_iterator::assign( const WIN32_FIND_DATAW& data )
+        {
+            m_entry.m_path = filesystem::path( m_directory + wstring_view( data.cFileName ) );
+            m_entry.m_file_size
+                = ( static_cast<uintmax_t>( data.nFileSizeHigh ) << 32 ) | data.nFileSizeLow;
+            m_entry.m_last_write_time
+                = ( static_cast<uint64_t>( data.ftLastWriteTime.dwHighDateTime ) << 32 )
+                  | data.ftLastWriteTime.dwLowDateTime;
+            m_entry.m_attributes = data.dwFileAttributes;
+        }
+
         const directory_entry& directory_iterator::operator*() const
         {
             return m_entry;
@@ -147,6 +201,7 @@ namespace rtl
             {
                 m_handle = rtl::move( other.m_handle );
                 m_entry = rtl::move( other.m_entry );
+                m_directory = rtl::move( other.m_directory );
 
                 other.m_handle = INVALID_HANDLE_VALUE;
             }
@@ -154,24 +209,1707 @@ namespace rtl
             return *this;
         }
 
-        size_t read_file_content( const wchar_t* name, void* p, size_t size )
+        struct recursive_directory_iterator::level
         {
-            HANDLE file = ::CreateFileW(
-                name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+            directory_iterator iterator;
+            level*             parent;
+        };
 
-            if ( file == INVALID_HANDLE_VALUE )
+        recursive_directory_iterator::recursive_directory_iterator( const filesystem::path& path )
+        {
+            directory_iterator iterator( path );
+
+            if ( iterator != directory_iterator() )
+                m_top = new level{ rtl::move( iterator ), nullptr };
+        }
+
+        recursive_directory_iterator::~recursive_directory_iterator()
+        {
+            while ( m_top )
+                drop_level();
+        }
+
+        recursive_directory_iterator& recursive_directory_iterator::operator++()
+        {
+            const directory_entry& entry = *m_top->iterator;
+
+            if ( m_recursion_pending && entry.is_directory() && !entry.is_symlink() )
+            {
+                directory_iterator child( entry.path() );
+
+                if ( child != directory_iterator() )
+                {
+                    m_top = new level{ rtl::move( child ), m_top };
+                    ++m_depth;
+
+                    return *this;
+                }
+            }
+
+            advance();
+            return *this;
+        }
+
+        void recursive_directory_iterator::pop()
+        {
+            drop_level();
+
+            if ( m_top )
+                advance();
+        }
+
+        void recursive_directory_iterator::advance()
+        {
+            m_recursion_pending = true;
+
+            ++m_top->iterator;
+
+            while ( m_top->iterator == directory_iterator() )
+            {
+                drop_level();
+
+                if ( m_top == nullptr )
+                    break;
+
+                ++m_top->iterator;
+            }
+        }
+
+        void recursive_directory_iterator::drop_level()
+        {
+            level* parent = m_top->parent;
+            delete m_top;
+
+            m_top = parent;
+            m_depth = parent ? m_depth - 1 : 0;
+        }
+
+        const directory_entry& recursive_directory_iterator::operator*() const
+        {
+            return *m_top->iterator;
+        }
+
+        bool recursive_directory_iterator::operator==(
+            const recursive_directory_iterator& rhs ) const
+        {
+            return m_top == rhs.m_top;
+        }
+
+        bool recursive_directory_iterator::operator!=(
+            const recursive_directory_iterator& rhs ) const
+        {
+            return !operator==( rhs );
+        }
+
+        recursive_directory_iterator::recursive_directory_iterator(
+            recursive_directory_iterator&& other )
+        {
+            *this = rtl::move( other );
+        }
+
+        recursive_directory_iterator&
+        recursive_directory_iterator::operator=( recursive_directory_iterator&& other )
+        {
+            if ( this != &other )
+            {
+                while ( m_top )
+                    drop_level();
+
+                m_top = other.m_top;
+                m_depth = other.m_depth;
+                m_recursion_pending = other.m_recursion_pending;
+
+                other.m_top = nullptr;
+                other.m_depth = 0;
+            }
+
+            return *this;
+        }
+
+        bool walk_entry::is_directory() const
+        {
+            return attributes & FILE_ATTRIBUTE_DIRECTORY;
+        }
+
+        namespace impl
+        {
+            struct walk_task
+            {
+                wstring directory; // ends with a separator
+                int     depth = 0;
+            };
+
+            // Tasks of one walk thread. The owner takes them from the back, so it goes depth
+            // first and stays in the directories it has just listed, idle threads steal from
+            // the front, which holds the largest unexplored subtrees.
+            class walk_queue final
+            {
+            public:
+                walk_queue()
+                {
+                    ::InitializeSRWLock( &m_lock );
+                }
+
+                ~walk_queue()
+                {
+                    delete[] m_tasks;
+                }
+
+                void push( walk_task&& task )
+                {
+                    ::AcquireSRWLockExclusive( &m_lock );
+
+                    if ( m_size == m_capacity )
+                        grow();
+
+                    m_tasks[( m_head + m_size ) & ( m_capacity - 1 )] = rtl::move( task );
+                    ++m_size;
+
+                    ::ReleaseSRWLockExclusive( &m_lock );
+                }
+
+                bool pop_back( walk_task& task )
+                {
+                    ::AcquireSRWLockExclusive( &m_lock );
+
+                    const bool found = m_size > 0;
+
+                    if ( found )
+                    {
+                        --m_size;
+                        task = rtl::move( m_tasks[( m_head + m_size ) & ( m_capacity - 1 )] );
+                    }
+
+                    ::ReleaseSRWLockExclusive( &m_lock );
+                    return found;
+                }
+
+                bool pop_front( walk_task& task )
+                {
+                    ::AcquireSRWLockExclusive( &m_lock );
+
+                    const bool found = m_size > 0;
+
+                    if ( found )
+                    {
+                        task = rtl::move( m_tasks[m_head] );
+                        m_head = ( m_head + 1 ) & ( m_capacity - 1 );
+                        --m_size;
+                    }
+
+                    ::ReleaseSRWLockExclusive( &m_lock );
+                    return found;
+                }
+
+            private:
+                void grow()
+                {
+                    const size_t capacity = m_capacity ? m_capacity * 2 : 64;
+                    walk_task*   tasks = new walk_task[capacity];
+
+                    for ( size_t i = 0; i < m_size; ++i )
+                        tasks[i] = rtl::move( m_tasks[( m_head + i ) & ( m_capacity - 1 )] );
+
+                    delete[] m_tasks;
+
+                    m_tasks = tasks;
+                    m_capacity = capacity;
+                    m_head = 0;
+                }
+
+                SRWLOCK    m_lock;
+                walk_task* m_tasks = nullptr;
+                size_t     m_capacity = 0;
+                size_t     m_head = 0;
+                size_t     m_size = 0;
+            };
+
+            struct walker
+            {
+                // NOTE: WaitForMultipleObjects limit
+                static constexpr int max_threads = MAXIMUM_WAIT_OBJECTS;
+
+                walk_function*      visitor;
+                void*               context;
+                const walk_options* options;
+                walk_queue*         queues;
+                int                 threads;
+
+                // tasks queued or being processed
+                volatile LONG pending;
+
+                // index source for the spawned threads, the calling thread is 0
+                volatile LONG started;
+
+                // tasks queued and not taken yet
+                volatile LONG queued;
+
+                // threads parked on 'idle' until a task is queued or the walk is over
+                volatile LONG      sleeping;
+                SRWLOCK            idle_lock;
+                CONDITION_VARIABLE idle;
+            };
+
+            [[nodiscard]] inline bool has_extension( const wstring_view& name,
+                                                     const wstring_view& extension )
+            {
+                const wstring_view tail = path_view( name ).extension().native();
+
+                if ( tail.size() != extension.size() )
+                    return false;
+
+                for ( size_t i = 0; i < extension.size(); ++i )
+                {
+                    wchar_t a = tail[i];
+                    wchar_t b = extension.data()[i];
+
+                    if ( a >= L'A' && a <= L'Z' )
+                        a += L'a' - L'A';
+
+                    if ( b >= L'A' && b <= L'Z' )
+                        b += L'a' - L'A';
+
+                    if ( a != b )
+                        return false;
+                }
+
+                return true;
+            }
+
+            inline void walk_wake( walker& w, bool all )
+            {
+                // NOTE: a thread that is about to park holds the lock from its last check of the
+                // tasks until it sleeps, so the wake can not slip in between
+                ::AcquireSRWLockExclusive( &w.idle_lock );
+                ::ReleaseSRWLockExclusive( &w.idle_lock );
+
+                if ( all )
+                    ::WakeAllConditionVariable( &w.idle );
+                else
+                    ::WakeConditionVariable( &w.idle );
+            }
+
+            inline void walk_push( walker& w, int self, walk_task&& task )
+            {
+                w.queues[self].push( rtl::move( task ) );
+
+                // NOTE: both counters are interlocked, so either a parking thread sees the task
+                // or the task's owner sees the parked thread
+                ::InterlockedIncrement( &w.queued );
+
+                if ( ::InterlockedCompareExchange( &w.sleeping, 0, 0 ) > 0 )
+                    walk_wake( w, false );
+            }
+
+            inline void walk_directory( walker& w, int self, const walk_task& task )
+            {
+                WIN32_FIND_DATAW data;
+
+                HANDLE handle = ::FindFirstFileExW( ( task.directory + L"*" ).c_str(),
+                                                    FindExInfoBasic,
+                                                    &data,
+                                                    FindExSearchNameMatch,
+                                                    nullptr,
+                                                    FIND_FIRST_EX_LARGE_FETCH );
+
+                if ( handle == INVALID_HANDLE_VALUE )
+                    return;
+
+                const walk_options& options = *w.options;
+
+                do
+                {
+                    if ( is_dot_or_dot_dot( data.cFileName ) )
+                        continue;
+
+                    const wstring_view name( data.cFileName );
+                    const bool directory = data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+
+                    // NOTE: filtered before anything is allocated for the entry
+                    const bool visit = directory ? options.directories
+                                                 : options.extension.empty()
+                                                       || has_extension( name, options.extension );
+
+                    if ( visit )
+                    {
+                        walk_entry entry;
+                        entry.directory = task.directory;
+                        entry.name = name;
+                        entry.file_size = ( static_cast<uintmax_t>( data.nFileSizeHigh ) << 32 )
+                                          | data.nFileSizeLow;
+                        entry.attributes = data.dwFileAttributes;
+                        entry.depth = task.depth;
+
+                        w.visitor( entry, w.context );
+                    }
+
+                    if ( directory && !( data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT ) )
+                    {
+                        ::InterlockedIncrement( &w.pending );
+                        walk_push(
+                            w, self, walk_task{ task.directory + name + L"/", task.depth + 1 } );
+                    }
+                } while ( ::FindNextFileW( handle, &data ) );
+
+                [[maybe_unused]] BOOL result = ::FindClose( handle );
+                RTL_WINAPI_CHECK( result );
+            }
+
+            inline void walk_worker( walker& w, int self )
+            {
+                walk_task task;
+
+                for ( ;; )
+                {
+                    bool found = w.queues[self].pop_back( task );
+
+                    for ( int i = 1; !found && i < w.threads; ++i )
+                        found = w.queues[( self + i ) % w.threads].pop_front( task );
+
+                    if ( found )
+                    {
+                        ::InterlockedDecrement( &w.queued );
+
+                        walk_directory( w, self, task );
+
+                        if ( ::InterlockedDecrement( &w.pending ) == 0 )
+                            walk_wake( w, true );
+                    }
+                    else if ( ::InterlockedCompareExchange( &w.pending, 0, 0 ) == 0 )
+                    {
+                        break;
+                    }
+                    else
+                    {
+                        // NOTE: the remaining directories are being listed by other threads,
+                        // this one parks until they queue subdirectories or the walk is over
+                        ::AcquireSRWLockExclusive( &w.idle_lock );
+                        ::InterlockedIncrement( &w.sleeping );
+
+                        while ( ::InterlockedCompareExchange( &w.queued, 0, 0 ) == 0
+                                && ::InterlockedCompareExchange( &w.pending, 0, 0 ) != 0 )
+                        {
+                            ::SleepConditionVariableSRW( &w.idle, &w.idle_lock, INFINITE, 0 );
+                        }
+
+                        ::InterlockedDecrement( &w.sleeping );
+                        ::ReleaseSRWLockExclusive( &w.idle_lock );
+                    }
+                }
+            }
+
+            inline DWORD WINAPI walk_thread( LPVOID parameter )
+            {
+                walker& w = *static_cast<walker*>( parameter );
+
+                walk_worker( w, ::InterlockedIncrement( &w.started ) );
                 return 0;
+            }
+        } // namespace impl
 
-            const DWORD bytes_to_read = size;
-            DWORD       bytes_read = 0;
+        void walk( const filesystem::path& root,
+                   walk_function*          visitor,
+                   void*                   context,
+                   const walk_options&     options )
+        {
+            int threads = options.threads;
 
-            BOOL result = ::ReadFile( file, p, bytes_to_read, &bytes_read, FALSE );
+            if ( threads <= 0 )
+            {
+                SYSTEM_INFO info;
+                ::GetSystemInfo( &info );
+
+                threads = static_cast<int>( info.dwNumberOfProcessors );
+            }
+
+            threads = rtl::clamp( threads, 1, impl::walker::max_threads );
+
+            impl::walker w;
+            w.visitor = visitor;
+            w.context = context;
+            w.options = &options;
+            w.queues = new impl::walk_queue[threads];
+            w.threads = threads;
+            w.pending = 1;
+            w.started = 0;
+            w.queued = 1;
+            w.sleeping = 0;
+
+            ::InitializeSRWLock( &w.idle_lock );
+            ::InitializeConditionVariable( &w.idle );
+
+            w.queues[0].push( impl::walk_task{ impl::with_separator( root.wstring() ), 0 } );
+
+            HANDLE handles[impl::walker::max_threads];
+            DWORD  count = 0;
+
+            for ( int i = 1; i < threads; ++i )
+            {
+                handles[count] = ::CreateThread( nullptr, 0, impl::walk_thread, &w, 0, nullptr );
+                RTL_WINAPI_CHECK( handles[count] != nullptr );
+
+                if ( handles[count] )
+                    ++count;
+            }
+
+            impl::walk_worker( w, 0 );
+
+            if ( count > 0 )
+            {
+                [[maybe_unused]] DWORD wait
+                    = ::WaitForMultipleObjects( count, handles, TRUE, INFINITE );
+                RTL_WINAPI_CHECK( wait < WAIT_OBJECT_0 + count );
+
+                for ( DWORD i = 0; i < count; ++i )
+                    ::CloseHandle( handles[i] );
+            }
+
+            delete[] w.queues;
+        }
+
+        struct watcher::state
+        {
+            OVERLAPPED   overlapped;
+            HANDLE       directory;
+            uint8_t*     buffers[2];
+            watch_event* events;
+            size_t       buffer_size;
+            int          current;
+            bool         recursive;
+            bool         pending;
+        };
+
+        namespace impl
+        {
+            // Folds a change into an earlier change of the same name, returns false if it has
+            // to be added as a separate event
+            [[nodiscard]] inline bool coalesce( watch_event* events,
+                                                int&         count,
+                                                watch_action action,
+                                                wstring_view name )
+            {
+                for ( int i = count - 1; i >= 0; --i )
+                {
+                    watch_event& e = events[i];
+
+                    if ( !( e.name == name ) )
+                        continue;
+
+                    if ( e.action == watch_action::renamed )
+                        return false;
+
+                    if ( e.action == watch_action::created && action == watch_action::removed )
+                    {
+                        // NOTE: a short-lived file is not reported at all, the later events
+                        // move down one by one since the ranges overlap
+                        for ( --count; i < count; ++i )
+                            events[i] = events[i + 1];
+                    }
+                    else if ( e.action == watch_action::removed )
+                    {
+                        e.action = action == watch_action::created ? watch_action::modified
+                                                                   : action;
+                    }
+                    else if ( action == watch_action::removed )
+                    {
+                        e.action = watch_action::removed;
+                    }
+
+                    return true;
+                }
+
+                return false;
+            }
+        } // namespace impl
+
+        watcher::watcher( const filesystem::path& directory, bool recursive, size_t buffer_size )
+        {
+            open( directory, recursive, buffer_size );
+        }
+
+        watcher::~watcher()
+        {
+            close();
+        }
+
+        bool watcher::open( const filesystem::path& directory, bool recursive, size_t buffer_size )
+        {
+            RTL_ASSERT( buffer_size >= sizeof( FILE_NOTIFY_INFORMATION ) );
+
+            close();
+
+            HANDLE handle = ::CreateFileW( directory.c_str(),
+                                           FILE_LIST_DIRECTORY,
+                                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                                           nullptr,
+                                           OPEN_EXISTING,
+                                           FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+                                           nullptr );
+
+            if ( handle == INVALID_HANDLE_VALUE )
+                return false;
+
+            // NOTE: the buffers must be DWORD-aligned, a record takes at least 16 bytes
+            buffer_size = ( buffer_size + 3 ) & ~size_t( 3 );
+
+            m_state = new state;
+            m_state->overlapped = OVERLAPPED{};
+            m_state->overlapped.hEvent = ::CreateEventW( nullptr, TRUE, FALSE, nullptr );
+            RTL_WINAPI_CHECK( m_state->overlapped.hEvent != nullptr );
+
+            m_state->directory = handle;
+            m_state->buffers[0] = new uint8_t[buffer_size * 2];
+            m_state->buffers[1] = m_state->buffers[0] + buffer_size;
+            m_state->events = new watch_event[buffer_size / 16];
+            m_state->buffer_size = buffer_size;
+            m_state->current = 0;
+            m_state->recursive = recursive;
+            m_state->pending = false;
+            m_failed = false;
+
+            issue();
+
+            return true;
+        }
+
+        void watcher::close()
+        {
+            if ( m_state == nullptr )
+                return;
+
+            [[maybe_unused]] BOOL result;
+
+            if ( m_state->pending )
+            {
+                ::CancelIoEx( m_state->directory, &m_state->overlapped );
+
+                // NOTE: the buffer must outlive the request even if it was cancelled
+                DWORD bytes;
+                ::GetOverlappedResult( m_state->directory, &m_state->overlapped, &bytes, TRUE );
+            }
+
+            result = ::CloseHandle( m_state->directory );
             RTL_WINAPI_CHECK( result );
 
-            result = ::CloseHandle( file );
+            result = ::CloseHandle( m_state->overlapped.hEvent );
             RTL_WINAPI_CHECK( result );
 
-            return bytes_read;
+            delete[] m_state->buffers[0];
+            delete[] m_state->events;
+            delete m_state;
+
+            m_state = nullptr;
+        }
+
+        void* watcher::handle() const
+        {
+            return m_state != nullptr ? m_state->overlapped.hEvent : nullptr;
+        }
+
+        void watcher::issue()
+        {
+            const BOOL result = ::ReadDirectoryChangesW(
+                m_state->directory,
+                m_state->buffers[m_state->current],
+                static_cast<DWORD>( m_state->buffer_size ),
+                m_state->recursive,
+                FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME
+                    | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE
+                    | FILE_NOTIFY_CHANGE_CREATION,
+                nullptr,
+                &m_state->overlapped,
+                nullptr );
+
+            m_state->pending = result != FALSE;
+            m_failed = !m_state->pending;
+        }
+
+        int watcher::poll( watch_function* callback, void* context, uint32_t timeout_ms )
+        {
+            RTL_ASSERT( callback != nullptr );
+
+            if ( m_state == nullptr || !m_state->pending )
+                return 0;
+
+            if ( ::WaitForSingleObject( m_state->overlapped.hEvent, timeout_ms ) != WAIT_OBJECT_0 )
+                return 0;
+
+            DWORD      bytes = 0;
+            const BOOL result = ::GetOverlappedResult(
+                m_state->directory, &m_state->overlapped, &bytes, FALSE );
+
+            m_state->pending = false;
+
+            if ( !result && ::GetLastError() != ERROR_NOTIFY_ENUM_DIR )
+            {
+                m_failed = true;
+                return 0;
+            }
+
+            // Changes keep being collected into the other buffer while this one is reported
+            const uint8_t* buffer = m_state->buffers[m_state->current];
+            m_state->current ^= 1;
+
+            issue();
+
+            // NOTE: the system reports an overflow of the buffer as an empty result
+            if ( bytes == 0 )
+            {
+                watch_event event = { watch_action::overflow, wstring_view(), wstring_view() };
+                callback( event, context );
+
+                return 1;
+            }
+
+            watch_event* events = m_state->events;
+            int          count = 0;
+            wstring_view old_name;
+
+            for ( DWORD offset = 0;; )
+            {
+                const FILE_NOTIFY_INFORMATION& info
+                    = *reinterpret_cast<const FILE_NOTIFY_INFORMATION*>( buffer + offset );
+
+                const wstring_view name( info.FileName, info.FileNameLength / sizeof( wchar_t ) );
+
+                // NOTE: the old name of a file moved out of the tree has no pair
+                if ( !old_name.empty() && info.Action != FILE_ACTION_RENAMED_NEW_NAME )
+                {
+                    if ( !impl::coalesce( events, count, watch_action::removed, old_name ) )
+                    {
+                        events[count++]
+                            = watch_event{ watch_action::removed, old_name, wstring_view() };
+                    }
+
+                    old_name = wstring_view();
+                }
+
+                watch_action action = watch_action::modified;
+
+                switch ( info.Action )
+                {
+                case FILE_ACTION_ADDED:
+                    action = watch_action::created;
+                    break;
+
+                case FILE_ACTION_REMOVED:
+                    action = watch_action::removed;
+                    break;
+
+                case FILE_ACTION_RENAMED_OLD_NAME:
+                    old_name = name;
+                    break;
+
+                case FILE_ACTION_RENAMED_NEW_NAME:
+                    action = old_name.empty() ? watch_action::created : watch_action::renamed;
+                    break;
+                }
+
+                if ( info.Action == FILE_ACTION_RENAMED_NEW_NAME && !old_name.empty() )
+                {
+                    events[count++] = watch_event{ action, name, old_name };
+                    old_name = wstring_view();
+                }
+                else if ( info.Action != FILE_ACTION_RENAMED_OLD_NAME
+                          && !impl::coalesce( events, count, action, name ) )
+                {
+                    events[count++] = watch_event{ action, name, wstring_view() };
+                }
+
+                if ( info.NextEntryOffset == 0 )
+                    break;
+
+                offset += info.NextEntryOffset;
+            }
+
+            if ( !old_name.empty()
+                 && !impl::coalesce( events, count, watch_action::removed, old_name ) )
+            {
+                events[count++] = watch_event{ watch_action::removed, old_name, wstring_view() };
+            }
+
+            for ( int i = 0; i < count; ++i )
+                callback( events[i], context );
+
+            return count;
+        }
+
+        size_t read_file_content( const wchar_t* name, void* p, size_t size )
+        {
+            HANDLE file = ::CreateFileW(
+                name, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0 );
+
+            if ( file == INVALID_HANDLE_VALUE )
+                return 0;
+
+            const DWORD bytes_to_read = size;
+            DWORD       bytes_read = 0;
+
+            BOOL result = ::ReadFile( file, p, bytes_to_read, &bytes_read, FALSE );
+            RTL_WINAPI_CHECK( result );
+
+            result = ::CloseHandle( file );
+            RTL_WINAPI_CHECK( result );
+
+            return bytes_read;
+        }
+
+        mapped_file::mapped_file( const filesystem::path& p, mode m, access a, share s )
+        {
+            open( p, m, a, s );
+        }
+
+        mapped_file::~mapped_file()
+        {
+            close();
+        }
+
+        mapped_file::mapped_file( mapped_file&& other )
+        {
+            *this = rtl::move( other );
+        }
+
+        mapped_file& mapped_file::operator=( mapped_file&& other )
+        {
+            if ( this != &other )
+            {
+                close();
+
+                m_file = other.m_file;
+                m_mapping = other.m_mapping;
+                m_data = other.m_data;
+                m_size = other.m_size;
+                m_mode = other.m_mode;
+
+                other.m_file = nullptr;
+                other.m_mapping = nullptr;
+                other.m_data = nullptr;
+                other.m_size = 0;
+            }
+
+            return *this;
+        }
+
+        bool mapped_file::open( const filesystem::path& p, mode m, access a, share s )
+        {
+            close();
+
+            const bool writable = m == mode::read_write;
+
+            DWORD flags = FILE_ATTRIBUTE_NORMAL;
+
+            if ( a == access::sequential )
+                flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+            else if ( a == access::random )
+                flags |= FILE_FLAG_RANDOM_ACCESS;
+
+            DWORD sharing = FILE_SHARE_READ;
+
+            if ( s == share::all )
+                sharing |= FILE_SHARE_WRITE | FILE_SHARE_DELETE;
+
+            HANDLE file = ::CreateFileW( p.c_str(),
+                                         writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                                         sharing,
+                                         nullptr,
+                                         OPEN_EXISTING,
+                                         flags,
+                                         nullptr );
+
+            if ( file == INVALID_HANDLE_VALUE )
+                return false;
+
+            LARGE_INTEGER file_size;
+
+            if ( !::GetFileSizeEx( file, &file_size )
+                 || static_cast<uint64_t>( file_size.QuadPart ) > static_cast<size_t>( -1 ) )
+            {
+                [[maybe_unused]] BOOL result = ::CloseHandle( file );
+                RTL_WINAPI_CHECK( result );
+
+                return false;
+            }
+
+            // NOTE: empty files can not be mapped, they are open with no view
+            if ( file_size.QuadPart > 0 )
+            {
+                HANDLE mapping = ::CreateFileMappingW(
+                    file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr );
+
+                void* view = nullptr;
+
+                if ( mapping )
+                    view = ::MapViewOfFile(
+                        mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0 );
+
+                if ( view == nullptr )
+                {
+                    if ( mapping )
+                        ::CloseHandle( mapping );
+
+                    ::CloseHandle( file );
+                    return false;
+                }
+
+                m_mapping = mapping;
+                m_data = static_cast<uint8_t*>( view );
+            }
+
+            m_file = file;
+            m_size = static_cast<size_t>( file_size.QuadPart );
+            m_mode = m;
+
+            return true;
+        }
+
+        void mapped_file::close()
+        {
+            [[maybe_unused]] BOOL result;
+
+            if ( m_data )
+            {
+                result = ::UnmapViewOfFile( m_data );
+                RTL_WINAPI_CHECK( result );
+            }
+
+            if ( m_mapping )
+            {
+                result = ::CloseHandle( m_mapping );
+                RTL_WINAPI_CHECK( result );
+            }
+
+            if ( m_file )
+            {
+                result = ::CloseHandle( m_file );
+                RTL_WINAPI_CHECK( result );
+            }
+
+            m_file = nullptr;
+            m_mapping = nullptr;
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        void mapped_file::prefetch( size_t offset, size_t size ) const
+        {
+            RTL_ASSERT( offset <= m_size && size <= m_size - offset );
+
+            if ( size == 0 )
+                return;
+
+#if _WIN32_WINNT >= _WIN32_WINNT_WIN8
+            WIN32_MEMORY_RANGE_ENTRY range;
+            range.VirtualAddress = m_data + offset;
+            range.NumberOfBytes = size;
+
+            // NOTE: only a hint, failure leaves the pages to be faulted in on access
+            ::PrefetchVirtualMemory( ::GetCurrentProcess(), 1, &range, 0 );
+#else
+            SYSTEM_INFO info;
+            ::GetSystemInfo( &info );
+
+            // NOTE: no asynchronous read-ahead before Windows 8, so fault the range in now. The
+            // walk starts at the page boundary, or it could step over the last page of the range.
+            const volatile uint8_t* page = m_data + offset - offset % info.dwPageSize;
+            const volatile uint8_t* end = m_data + offset + size;
+
+            for ( ; page < end; page += info.dwPageSize )
+                static_cast<void>( *page );
+#endif
+        }
+
+        bool mapped_file::flush()
+        {
+            if ( m_data == nullptr || m_mode != mode::read_write )
+                return is_open();
+
+            return ::FlushViewOfFile( m_data, 0 ) && ::FlushFileBuffers( m_file );
+        }
+
+        struct stream_reader::request
+        {
+            OVERLAPPED overlapped;
+            uint8_t*   data;
+            uint64_t   offset;
+            bool       pending;
+        };
+
+        stream_reader::stream_reader( const filesystem::path& p, size_t chunk_size, int buffers )
+        {
+            open( p, chunk_size, buffers );
+        }
+
+        stream_reader::~stream_reader()
+        {
+            close();
+        }
+
+        bool stream_reader::open( const filesystem::path& p, size_t chunk_size, int buffers )
+        {
+            RTL_ASSERT( chunk_size > 0 );
+            RTL_ASSERT( buffers >= 2 && buffers <= max_buffers );
+
+            close();
+
+            HANDLE file = ::CreateFileW( p.c_str(),
+                                         GENERIC_READ,
+                                         FILE_SHARE_READ,
+                                         nullptr,
+                                         OPEN_EXISTING,
+                                         FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN,
+                                         nullptr );
+
+            if ( file == INVALID_HANDLE_VALUE )
+                return false;
+
+            LARGE_INTEGER file_size;
+
+            if ( !::GetFileSizeEx( file, &file_size ) )
+            {
+                [[maybe_unused]] BOOL result = ::CloseHandle( file );
+                RTL_WINAPI_CHECK( result );
+
+                return false;
+            }
+
+            m_file = file;
+            m_file_size = static_cast<uint64_t>( file_size.QuadPart );
+            m_chunk_size = chunk_size;
+            m_buffers = buffers;
+            m_memory = new uint8_t[chunk_size * buffers];
+            m_requests = new request[buffers];
+
+            for ( int i = 0; i < buffers; ++i )
+            {
+                request& r = m_requests[i];
+
+                r.overlapped = OVERLAPPED{};
+                r.overlapped.hEvent = ::CreateEventW( nullptr, TRUE, FALSE, nullptr );
+                RTL_WINAPI_CHECK( r.overlapped.hEvent != nullptr );
+
+                r.data = m_memory + chunk_size * i;
+                r.pending = false;
+
+                issue( r );
+            }
+
+            return true;
+        }
+
+        void stream_reader::close()
+        {
+            if ( m_file == nullptr )
+                return;
+
+            [[maybe_unused]] BOOL result;
+
+            ::CancelIoEx( m_file, nullptr );
+
+            for ( int i = 0; i < m_buffers; ++i )
+            {
+                request& r = m_requests[i];
+
+                // NOTE: the buffer must outlive the read even if it was cancelled
+                if ( r.pending )
+                {
+                    DWORD bytes_read;
+                    ::GetOverlappedResult( m_file, &r.overlapped, &bytes_read, TRUE );
+                }
+
+                result = ::CloseHandle( r.overlapped.hEvent );
+                RTL_WINAPI_CHECK( result );
+            }
+
+            result = ::CloseHandle( m_file );
+            RTL_WINAPI_CHECK( result );
+
+            delete[] m_requests;
+            delete[] m_memory;
+
+            m_file = nullptr;
+            m_requests = nullptr;
+            m_memory = nullptr;
+            m_file_size = 0;
+            m_read_offset = 0;
+            m_position = 0;
+            m_chunk_size = 0;
+            m_buffers = 0;
+            m_head = 0;
+            m_consumed = -1;
+            m_failed = false;
+        }
+
+        void stream_reader::issue( request& r )
+        {
+            if ( m_failed || m_read_offset >= m_file_size )
+                return;
+
+            r.offset = m_read_offset;
+            r.overlapped.Offset = static_cast<DWORD>( r.offset );
+            r.overlapped.OffsetHigh = static_cast<DWORD>( r.offset >> 32 );
+
+            [[maybe_unused]] BOOL result = ::ResetEvent( r.overlapped.hEvent );
+            RTL_WINAPI_CHECK( result );
+
+            // NOTE: may also complete synchronously, the event is signaled in both cases
+            if ( !::ReadFile(
+                     m_file, r.data, static_cast<DWORD>( m_chunk_size ), nullptr, &r.overlapped ) )
+            {
+                const DWORD error = ::GetLastError();
+
+                if ( error != ERROR_IO_PENDING )
+                {
+                    // NOTE: the file was truncated after it had been opened
+                    if ( error == ERROR_HANDLE_EOF )
+                        m_read_offset = m_file_size;
+                    else
+                        m_failed = true;
+
+                    return;
+                }
+            }
+
+            r.pending = true;
+            m_read_offset += m_chunk_size;
+        }
+
+        span<const uint8_t> stream_reader::next()
+        {
+            if ( m_file == nullptr )
+                return span<const uint8_t>();
+
+            // the caller is done with the previous chunk, reuse its buffer for read-ahead
+            if ( m_consumed >= 0 )
+                issue( m_requests[m_consumed] );
+
+            request& r = m_requests[m_head];
+
+            if ( !r.pending )
+                return span<const uint8_t>();
+
+            DWORD bytes_read = 0;
+
+            const BOOL result = ::GetOverlappedResult( m_file, &r.overlapped, &bytes_read, TRUE );
+
+            r.pending = false;
+
+            if ( !result )
+            {
+                m_failed = ::GetLastError() != ERROR_HANDLE_EOF;
+
+                // NOTE: the buffer of the previous chunk is already reading ahead, it must not be
+                // issued again while its read is in flight
+                m_read_offset = m_file_size;
+                m_consumed = -1;
+
+                return span<const uint8_t>();
+            }
+
+            m_position = r.offset;
+            m_consumed = m_head;
+            m_head = ( m_head + 1 ) % m_buffers;
+
+            return span<const uint8_t>( r.data, bytes_read );
+        }
+
+        file_writer::file_writer( const filesystem::path& p, mode m, size_t buffer_size )
+        {
+            open( p, m, buffer_size );
+        }
+
+        file_writer::~file_writer()
+        {
+            close();
+        }
+
+        bool file_writer::open( const filesystem::path& p, mode m, size_t buffer_size )
+        {
+            RTL_ASSERT( buffer_size > 0 );
+
+            close();
+
+            // NOTE: the temporary file is on the same volume, so the final rename is atomic
+            m_temporary = m == mode::atomic ? filesystem::path( p.wstring() + L".tmp" )
+                                            : filesystem::path();
+
+            const filesystem::path& name = m == mode::atomic ? m_temporary : p;
+
+            HANDLE file = ::CreateFileW( name.c_str(),
+                                         GENERIC_WRITE,
+                                         0,
+                                         nullptr,
+                                         CREATE_ALWAYS,
+                                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                         nullptr );
+
+            if ( file == INVALID_HANDLE_VALUE )
+                return false;
+
+            m_target = p;
+            m_file = file;
+            m_buffer = new uint8_t[buffer_size];
+            m_capacity = buffer_size;
+            m_used = 0;
+            m_size = 0;
+            m_mode = m;
+            m_failed = false;
+
+            return true;
+        }
+
+        void file_writer::close()
+        {
+            finish( m_mode == mode::truncate );
+        }
+
+        bool file_writer::commit()
+        {
+            RTL_ASSERT( m_file != nullptr );
+
+            return finish( true );
+        }
+
+        bool file_writer::finish( bool keep )
+        {
+            if ( m_file == nullptr )
+                return false;
+
+            const bool atomic = m_mode == mode::atomic;
+
+            // NOTE: the data must be on the disk before the rename is
+            bool succeeded = keep && ( atomic ? sync() : flush() );
+
+            [[maybe_unused]] BOOL result = ::CloseHandle( m_file );
+            RTL_WINAPI_CHECK( result );
+
+            if ( atomic )
+            {
+                if ( succeeded )
+                {
+                    succeeded = ::MoveFileExW( m_temporary.c_str(),
+                                               m_target.c_str(),
+                                               MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH );
+                }
+
+                if ( !succeeded )
+                    ::DeleteFileW( m_temporary.c_str() );
+            }
+
+            delete[] m_buffer;
+
+            m_file = nullptr;
+            m_buffer = nullptr;
+            m_capacity = 0;
+            m_used = 0;
+
+            return succeeded;
+        }
+
+        bool file_writer::write( const void* data, size_t size )
+        {
+            RTL_ASSERT( m_file != nullptr );
+
+            if ( m_failed )
+                return false;
+
+            const uint8_t* src = static_cast<const uint8_t*>( data );
+
+            m_size += size;
+
+            if ( size > m_capacity - m_used )
+            {
+                // Fills up the buffer first, so writes stay multiples of the buffer size
+                if ( m_used > 0 )
+                {
+                    const size_t length = m_capacity - m_used;
+
+                    rtl::copy_n( src, length, m_buffer + m_used );
+                    m_used = m_capacity;
+                    src += length;
+                    size -= length;
+
+                    if ( !flush() )
+                        return false;
+                }
+
+                if ( size >= m_capacity )
+                {
+                    const size_t length = size - size % m_capacity;
+
+                    if ( !write_file( src, length ) )
+                        return false;
+
+                    src += length;
+                    size -= length;
+                }
+            }
+
+            rtl::copy_n( src, size, m_buffer + m_used );
+            m_used += size;
+
+            return true;
+        }
+
+        bool file_writer::write( span<const span<const uint8_t>> pieces )
+        {
+            for ( const span<const uint8_t>& piece : pieces )
+            {
+                if ( !write( piece.data(), piece.size() ) )
+                    return false;
+            }
+
+            return true;
+        }
+
+        bool file_writer::flush()
+        {
+            RTL_ASSERT( m_file != nullptr );
+
+            if ( m_failed )
+                return false;
+
+            if ( m_used == 0 )
+                return true;
+
+            const size_t used = m_used;
+            m_used = 0;
+
+            return write_file( m_buffer, used );
+        }
+
+        bool file_writer::sync()
+        {
+            if ( !flush() )
+                return false;
+
+            if ( !::FlushFileBuffers( m_file ) )
+                m_failed = true;
+
+            return !m_failed;
+        }
+
+        bool file_writer::write_file( const void* data, size_t size )
+        {
+            DWORD written;
+
+            if ( !::WriteFile( m_file, data, static_cast<DWORD>( size ), &written, nullptr )
+                 || written != size )
+            {
+                m_failed = true;
+            }
+
+            return !m_failed;
+        }
+
+        struct file_cache::entry
+        {
+            entry*           chain;
+            entry*           newer;
+            entry*           older;
+            filesystem::path path;
+            size_t           hash;
+            uint64_t         last_write_time;
+            uintmax_t        file_size;
+            const uint8_t*   data;
+            mapped_file      mapping;
+            size_t           size;
+
+            ~entry()
+            {
+                if ( !mapping.is_open() )
+                    delete[] data;
+            }
+        };
+
+        file_cache::file_cache( size_t budget, size_t map_threshold )
+            : m_budget( budget )
+            , m_map_threshold( map_threshold )
+        {
+            rehash( 16 );
+        }
+
+        file_cache::~file_cache()
+        {
+            clear();
+            delete[] m_buckets;
+        }
+
+        span<const uint8_t> file_cache::get( const filesystem::path& p )
+        {
+            // NOTE: one attributes query validates a hit, the file is not opened
+            const directory_entry file( p );
+            const size_t          hash = rtl::hash<filesystem::path>()( p );
+
+            entry* e = find( p, hash );
+
+            if ( e != nullptr )
+            {
+                unlink( e );
+
+                if ( e->last_write_time == file.last_write_time()
+                     && e->file_size == file.file_size() && file.exists() )
+                {
+                    ++m_stats.hits;
+                    link( e );
+
+                    return span<const uint8_t>( e->data, e->size );
+                }
+
+                delete e;
+            }
+
+            ++m_stats.misses;
+
+            if ( !file.exists() || file.is_directory()
+                 || file.file_size() > static_cast<size_t>( -1 ) )
+            {
+                return span<const uint8_t>();
+            }
+
+            e = load( file, hash );
+
+            if ( e == nullptr )
+                return span<const uint8_t>();
+
+            link( e );
+            evict( e );
+
+            return span<const uint8_t>( e->data, e->size );
+        }
+
+        void file_cache::clear()
+        {
+            while ( m_oldest != nullptr )
+            {
+                entry* e = m_oldest;
+
+                unlink( e );
+                delete e;
+            }
+        }
+
+        file_cache::entry* file_cache::find( const filesystem::path& p, size_t hash ) const
+        {
+            for ( entry* e = m_buckets[hash & ( m_bucket_count - 1 )]; e != nullptr; e = e->chain )
+            {
+                if ( e->hash == hash && e->path == p )
+                    return e;
+            }
+
+            return nullptr;
+        }
+
+        file_cache::entry* file_cache::load( const directory_entry& file, size_t hash )
+        {
+            entry* e = new entry{};
+
+            e->path = file.path();
+            e->hash = hash;
+            e->last_write_time = file.last_write_time();
+            e->file_size = file.file_size();
+            e->size = static_cast<size_t>( file.file_size() );
+
+            if ( e->size >= m_map_threshold )
+            {
+                const bool mapped = e->mapping.open( file.path(),
+                                                     mapped_file::mode::read_only,
+                                                     mapped_file::access::normal,
+                                                     mapped_file::share::all );
+
+                if ( mapped && e->mapping.size() == e->size )
+                {
+                    e->data = e->mapping.data();
+                    return e;
+                }
+            }
+            else
+            {
+                uint8_t* buffer = new uint8_t[e->size];
+                e->data = buffer;
+
+                if ( read_file_content( file.path().c_str(), buffer, e->size ) == e->size )
+                    return e;
+            }
+
+            delete e;
+            return nullptr;
+        }
+
+        void file_cache::link( entry* e )
+        {
+            if ( m_count >= m_bucket_count )
+                rehash( m_bucket_count * 2 );
+
+            entry*& bucket = m_buckets[e->hash & ( m_bucket_count - 1 )];
+
+            e->chain = bucket;
+            bucket = e;
+
+            e->newer = nullptr;
+            e->older = m_newest;
+
+            if ( m_newest != nullptr )
+                m_newest->newer = e;
+            else
+                m_oldest = e;
+
+            m_newest = e;
+
+            m_size += e->size;
+            ++m_count;
+        }
+
+        void file_cache::unlink( entry* e )
+        {
+            entry** link = &m_buckets[e->hash & ( m_bucket_count - 1 )];
+
+            while ( *link != e )
+                link = &( *link )->chain;
+
+            *link = e->chain;
+
+            ( e->newer != nullptr ? e->newer->older : m_newest ) = e->older;
+            ( e->older != nullptr ? e->older->newer : m_oldest ) = e->newer;
+
+            m_size -= e->size;
+            --m_count;
+        }
+
+        void file_cache::evict( const entry* keep )
+        {
+            while ( m_size > m_budget && m_oldest != keep )
+            {
+                entry* e = m_oldest;
+
+                unlink( e );
+                delete e;
+
+                ++m_stats.evictions;
+            }
+        }
+
+        void file_cache::rehash( size_t bucket_count )
+        {
+            RTL_ASSERT( has_single_bit( bucket_count ) );
+
+            entry** buckets = new entry*[bucket_count]();
+
+            for ( size_t i = 0; i < m_bucket_count; ++i )
+            {
+                while ( entry* e = m_buckets[i] )
+                {
+                    m_buckets[i] = e->chain;
+
+                    entry*& bucket = buckets[e->hash & ( bucket_count - 1 )];
+                    e->chain = bucket;
+                    bucket = e;
+                }
+            }
+
+            delete[] m_buckets;
+
+            m_buckets = buckets;
+            m_bucket_count = bucket_count;
+        }
+
+        io_queue::io_queue()
+            : m_port( ::CreateIoCompletionPort( INVALID_HANDLE_VALUE, nullptr, 0, 1 ) )
+        {
+            RTL_WINAPI_CHECK( m_port != nullptr );
+        }
+
+        io_queue::~io_queue()
+        {
+            RTL_ASSERT( m_pending == 0 );
+
+            [[maybe_unused]] BOOL result = ::CloseHandle( m_port );
+            RTL_WINAPI_CHECK( result );
+        }
+
+        int io_queue::poll( uint32_t timeout_ms )
+        {
+            if ( m_pending == 0 )
+                return 0;
+
+            OVERLAPPED_ENTRY entries[64];
+            ULONG            count = 0;
+
+            if ( !::GetQueuedCompletionStatusEx( m_port, entries, 64, &count, timeout_ms, FALSE ) )
+                return 0;
+
+            for ( ULONG i = 0; i < count; ++i )
+            {
+                // NOTE: the OVERLAPPED is the first member of the request
+                io_request& request = *reinterpret_cast<io_request*>( entries[i].lpOverlapped );
+
+                DWORD      bytes = 0;
+                const BOOL result = ::GetOverlappedResult(
+                    request.m_file, entries[i].lpOverlapped, &bytes, FALSE );
+
+                request.m_bytes = bytes;
+                request.m_error = result ? 0 : ::GetLastError();
+                request.m_pending = false;
+
+                --m_pending;
+
+                if ( request.m_callback )
+                    request.m_callback( request, request.m_context );
+            }
+
+            return static_cast<int>( count );
+        }
+
+        void io_queue::wait()
+        {
+            while ( m_pending > 0 )
+                poll( INFINITE );
+        }
+
+        async_file::async_file( io_queue& queue, const filesystem::path& p, mode m )
+        {
+            open( queue, p, m );
+        }
+
+        async_file::~async_file()
+        {
+            close();
+        }
+
+        bool async_file::open( io_queue& queue, const filesystem::path& p, mode m )
+        {
+            close();
+
+            DWORD access = GENERIC_READ;
+            DWORD disposition = OPEN_EXISTING;
+
+            if ( m == mode::write )
+            {
+                access = GENERIC_WRITE;
+                disposition = CREATE_ALWAYS;
+            }
+            else if ( m == mode::read_write )
+            {
+                access = GENERIC_READ | GENERIC_WRITE;
+                disposition = OPEN_ALWAYS;
+            }
+
+            HANDLE file = ::CreateFileW( p.c_str(),
+                                         access,
+                                         FILE_SHARE_READ,
+                                         nullptr,
+                                         disposition,
+                                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED,
+                                         nullptr );
+
+            if ( file == INVALID_HANDLE_VALUE )
+                return false;
+
+            if ( ::CreateIoCompletionPort( file, queue.m_port, 0, 0 ) == nullptr )
+            {
+                [[maybe_unused]] BOOL result = ::CloseHandle( file );
+                RTL_WINAPI_CHECK( result );
+
+                return false;
+            }
+
+            m_queue = &queue;
+            m_file = file;
+
+            return true;
+        }
+
+        void async_file::close()
+        {
+            if ( m_file == nullptr )
+                return;
+
+            ::CancelIoEx( m_file, nullptr );
+
+            [[maybe_unused]] BOOL result = ::CloseHandle( m_file );
+            RTL_WINAPI_CHECK( result );
+
+            m_queue = nullptr;
+            m_file = nullptr;
+        }
+
+        uint64_t async_file::size() const
+        {
+            LARGE_INTEGER size;
+
+            if ( m_file == nullptr || !::GetFileSizeEx( m_file, &size ) )
+                return 0;
+
+            return static_cast<uint64_t>( size.QuadPart );
+        }
+
+        bool async_file::read_at( io_request&  request,
+                                  uint64_t     offset,
+                                  void*        buffer,
+                                  size_t       size,
+                                  io_callback* callback,
+                                  void*        context )
+        {
+            request.m_callback = callback;
+            request.m_context = context;
+
+            return submit( request, offset, buffer, size, false );
+        }
+
+        bool async_file::write_at( io_request&  request,
+                                   uint64_t     offset,
+                                   const void*  buffer,
+                                   size_t       size,
+                                   io_callback* callback,
+                                   void*        context )
+        {
+            request.m_callback = callback;
+            request.m_context = context;
+
+            return submit( request, offset, const_cast<void*>( buffer ), size, true );
+        }
+
+        bool async_file::submit( io_request& request,
+                                 uint64_t    offset,
+                                 void*       buffer,
+                                 size_t      size,
+                                 bool        write )
+        {
+            RTL_ASSERT( m_file != nullptr );
+            RTL_ASSERT( !request.m_pending );
+
+            static_assert( sizeof( OVERLAPPED ) <= sizeof( request.m_overlapped ) );
+
+            OVERLAPPED& overlapped = *reinterpret_cast<OVERLAPPED*>( request.m_overlapped );
+
+            overlapped = OVERLAPPED{};
+            overlapped.Offset = static_cast<DWORD>( offset );
+            overlapped.OffsetHigh = static_cast<DWORD>( offset >> 32 );
+
+            request.m_file = m_file;
+            request.m_bytes = 0;
+            request.m_error = 0;
+
+            const DWORD length = static_cast<DWORD>( size );
+
+            // NOTE: a synchronous success is still queued to the completion port
+            const BOOL result = write ? ::WriteFile( m_file, buffer, length, nullptr, &overlapped )
+                                      : ::ReadFile( m_file, buffer, length, nullptr, &overlapped );
+
+            if ( !result )
+            {
+                const DWORD error = ::GetLastError();
+
+                if ( error != ERROR_IO_PENDING )
+                {
+                    request.m_error = error;
+                    return false;
+                }
+            }
+
+            request.m_pending = true;
+            ++m_queue->m_pending;
+
+            return true;
         }
     } // namespace filesystem
 } // namespace rtl
@@ -21,8 +21,216 @@
 #if RTL_ENABLE_MEMSET
 
     #pragma function( memset )
+    #pragma function( memcpy )
 
 extern "C" void* __cdecl memset( void* dest, int ch, size_t count );
+extern "C" void* __cdecl memcpy( void* dest, const void* src, size_t count );
+extern "C" void* __cdecl memmove( void* dest, const void* src, size_t count );
+
+    #if RTL_ENABLE_MEMSET_SPEED
+
+        #include <emmintrin.h>
+        #include <intrin.h>
+
+namespace rtl
+{
+    namespace impl
+    {
+        namespace memory
+        {
+            // NOTE: 'rep stosb/movsb' outperforms vector loops on large blocks since Ivy Bridge
+            constexpr size_t rep_threshold = 2048;
+
+            void fill( uint8_t* dst, uint8_t value, size_t count )
+            {
+                // Jump table for small blocks
+                switch ( count )
+                {
+                case 15: dst[14] = value; [[fallthrough]];
+                case 14: dst[13] = value; [[fallthrough]];
+                case 13: dst[12] = value; [[fallthrough]];
+                case 12: dst[11] = value; [[fallthrough]];
+                case 11: dst[10] = value; [[fallthrough]];
+                case 10: dst[9] = value; [[fallthrough]];
+                case 9: dst[8] = value; [[fallthrough]];
+                case 8: dst[7] = value; [[fallthrough]];
+                case 7: dst[6] = value; [[fallthrough]];
+                case 6: dst[5] = value; [[fallthrough]];
+                case 5: dst[4] = value; [[fallthrough]];
+                case 4: dst[3] = value; [[fallthrough]];
+                case 3: dst[2] = value; [[fallthrough]];
+                case 2: dst[1] = value; [[fallthrough]];
+                case 1: dst[0] = value; [[fallthrough]];
+                case 0: return;
+                }
+
+                if ( count >= rep_threshold )
+                {
+                    __stosb( dst, value, count );
+                    return;
+                }
+
+                const __m128i v = _mm_set1_epi8( static_cast<char>( value ) );
+
+                uint8_t* const end = dst + count;
+
+                // NOTE: unaligned head and tail overlap the aligned body
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), v );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( end - 16 ), v );
+
+                uint8_t* p = reinterpret_cast<uint8_t*>( ( reinterpret_cast<uintptr_t>( dst ) + 16 )
+                                                         & ~uintptr_t( 15 ) );
+
+                for ( ; p + 32 <= end; p += 32 )
+                {
+                    _mm_store_si128( reinterpret_cast<__m128i*>( p ), v );
+                    _mm_store_si128( reinterpret_cast<__m128i*>( p + 16 ), v );
+                }
+
+                if ( p + 16 <= end )
+                    _mm_store_si128( reinterpret_cast<__m128i*>( p ), v );
+            }
+
+            // NOTE: all loads precede all stores, so overlapping blocks are handled too
+            void copy_small( uint8_t* dst, const uint8_t* src, size_t count )
+            {
+                if ( count >= 16 )
+                {
+                    const __m128i head = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+                    const __m128i tail
+                        = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + count - 16 ) );
+
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), head );
+                    _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + count - 16 ), tail );
+                }
+                else if ( count >= 8 )
+                {
+                    const __m128i head = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( src ) );
+                    const __m128i tail
+                        = _mm_loadl_epi64( reinterpret_cast<const __m128i*>( src + count - 8 ) );
+
+                    _mm_storel_epi64( reinterpret_cast<__m128i*>( dst ), head );
+                    _mm_storel_epi64( reinterpret_cast<__m128i*>( dst + count - 8 ), tail );
+                }
+                else if ( count >= 4 )
+                {
+                    const uint32_t head = *reinterpret_cast<const uint32_t*>( src );
+                    const uint32_t tail = *reinterpret_cast<const uint32_t*>( src + count - 4 );
+
+                    *reinterpret_cast<uint32_t*>( dst ) = head;
+                    *reinterpret_cast<uint32_t*>( dst + count - 4 ) = tail;
+                }
+                else if ( count > 0 )
+                {
+                    const uint8_t first = src[0];
+                    const uint8_t middle = src[count / 2];
+                    const uint8_t last = src[count - 1];
+
+                    dst[0] = first;
+                    dst[count / 2] = middle;
+                    dst[count - 1] = last;
+                }
+            }
+
+            // NOTE: count > 32; safe for overlapping blocks if dst < src
+            void copy_forward( uint8_t* dst, const uint8_t* src, size_t count )
+            {
+                const __m128i head = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+                const __m128i tail
+                    = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + count - 16 ) );
+
+                size_t i = ( ( reinterpret_cast<uintptr_t>( dst ) + 16 ) & ~uintptr_t( 15 ) )
+                           - reinterpret_cast<uintptr_t>( dst );
+
+                for ( ; i + 32 <= count; i += 32 )
+                {
+                    const __m128i a
+                        = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+                    const __m128i b
+                        = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i + 16 ) );
+
+                    _mm_store_si128( reinterpret_cast<__m128i*>( dst + i ), a );
+                    _mm_store_si128( reinterpret_cast<__m128i*>( dst + i + 16 ), b );
+                }
+
+                if ( i + 16 <= count )
+                {
+                    const __m128i a
+                        = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+                    _mm_store_si128( reinterpret_cast<__m128i*>( dst + i ), a );
+                }
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), head );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + count - 16 ), tail );
+            }
+
+            // NOTE: count > 32; safe for overlapping blocks if dst > src
+            void copy_backward( uint8_t* dst, const uint8_t* src, size_t count )
+            {
+                const __m128i head = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src ) );
+                const __m128i tail
+                    = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + count - 16 ) );
+
+                size_t i = ( ( reinterpret_cast<uintptr_t>( dst ) + count ) & ~uintptr_t( 15 ) )
+                           - reinterpret_cast<uintptr_t>( dst );
+
+                while ( i > 16 )
+                {
+                    i -= 16;
+
+                    const __m128i a
+                        = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+                    _mm_store_si128( reinterpret_cast<__m128i*>( dst + i ), a );
+                }
+
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + count - 16 ), tail );
+                _mm_storeu_si128( reinterpret_cast<__m128i*>( dst ), head );
+            }
+        } // namespace memory
+    }     // namespace impl
+} // namespace rtl
+
+void* __cdecl memset( void* dest, int ch, size_t count )
+{
+    rtl::impl::memory::fill(
+        static_cast<rtl::uint8_t*>( dest ), static_cast<rtl::uint8_t>( ch ), count );
+
+    return dest;
+}
+
+void* __cdecl memcpy( void* dest, const void* src, size_t count )
+{
+    auto*       dst = static_cast<rtl::uint8_t*>( dest );
+    const auto* from = static_cast<const rtl::uint8_t*>( src );
+
+    if ( count <= 32 )
+        rtl::impl::memory::copy_small( dst, from, count );
+    else if ( count >= rtl::impl::memory::rep_threshold )
+        __movsb( dst, from, count );
+    else
+        rtl::impl::memory::copy_forward( dst, from, count );
+
+    return dest;
+}
+
+void* __cdecl memmove( void* dest, const void* src, size_t count )
+{
+    auto*       dst = static_cast<rtl::uint8_t*>( dest );
+    const auto* from = static_cast<const rtl::uint8_t*>( src );
+
+    if ( count <= 32 )
+        rtl::impl::memory::copy_small( dst, from, count );
+    else if ( dst + count <= from || from + count <= dst )
+        memcpy( dest, src, count );
+    else if ( dst < from )
+        rtl::impl::memory::copy_forward( dst, from, count );
+    else if ( dst > from )
+        rtl::impl::memory::copy_backward( dst, from, count );
+
+    return dest;
+}
+
+    #else
 
 void* __cdecl memset( void* dest, int ch, size_t count )
 {
@@ -34,6 +242,38 @@ void* __cdecl memset( void* dest, int ch, size_t count )
     return dest;
 }
 
+void* __cdecl memcpy( void* dest, const void* src, size_t count )
+{
+    char*       dst = static_cast<char*>( dest );
+    const char* from = static_cast<const char*>( src );
+
+    for ( ; count; --count )
+        *dst++ = *from++;
+
+    return dest;
+}
+
+void* __cdecl memmove( void* dest, const void* src, size_t count )
+{
+    char*       dst = static_cast<char*>( dest );
+    const char* from = static_cast<const char*>( src );
+
+    if ( dst < from )
+    {
+        for ( ; count; --count )
+            *dst++ = *from++;
+    }
+    else if ( dst > from )
+    {
+        for ( dst += count, from += count; count; --count )
+            *--dst = *--from;
+    }
+
+    return dest;
+}
+
+    #endif
+
 #endif
 
 #if RTL_ENABLE_HEAP
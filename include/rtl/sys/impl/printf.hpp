@@ -14,6 +14,9 @@
     #error "Do not include implementation header directly, use <rtl/sys/impl.hpp>"
 #endif
 
+#include <rtl/memory.hpp>
+#include <rtl/utf.hpp>
+
 #include "debug.hpp"
 #include "win.hpp"
 
@@ -40,9 +43,16 @@ namespace rtl
         constexpr size_t fmt_buffer_size = 1024;
         wchar_t          fmt_buffer[fmt_buffer_size];
 
-        [[maybe_unused]] const int res = ::MultiByteToWideChar(
-            CP_UTF8, MB_PRECOMPOSED, fmt, -1, fmt_buffer, fmt_buffer_size );
-        RTL_WINAPI_CHECK( res != 0 );
+        // NOTE: the terminator is converted too
+        const size_t fmt_size = rtl::string_view( fmt ).size() + 1;
+        const size_t wide_fmt_size = rtl::utf8_to_wide( fmt, fmt_size );
+
+        rtl::unique_ptr<wchar_t[]> wide_fmt;
+        if ( wide_fmt_size > fmt_buffer_size )
+            wide_fmt.reset( new wchar_t[wide_fmt_size] );
+
+        wchar_t* const wfmt = wide_fmt ? wide_fmt.get() : fmt_buffer;
+        (void)rtl::utf8_to_wide( fmt, fmt_size, wfmt );
 
         va_list args;
         va_start( args, fmt );
@@ -50,7 +60,7 @@ namespace rtl
         // TODO: Use safer realization of printf or proove safity (NOTE: StringCbVPrintfW is
         // inapplicable)
         // TODO: %f support
-        const int result = ::wvsprintfW( buffer, fmt_buffer, args );
+        const int result = ::wvsprintfW( buffer, wfmt, args );
 
         va_end( args );
 
@@ -14,12 +14,27 @@
     #error "Do not include implementation header directly, use <rtl/sys/impl.hpp>"
 #endif
 
+#include <rtl/algorithm.hpp>
+#include <rtl/archive.hpp>
+#include <rtl/charconv.hpp>
+#include <rtl/fix.hpp>
+#include <rtl/fix_batch.hpp>
+#include <rtl/fix_math.hpp>
+#include <rtl/fourcc.hpp>
+#include <rtl/hash.hpp>
+#include <rtl/lz4.hpp>
 #include <rtl/math.hpp>
+#include <rtl/noise.hpp>
+#include <rtl/random.hpp>
+#include <rtl/riff.hpp>
 #include <rtl/string.hpp>
+#include <rtl/utf.hpp>
 
 #include <rtl/sys/debug.hpp>
 #include <rtl/sys/filesystem.hpp>
 
+#include "win.hpp"
+
 #if RTL_ENABLE_RUNTIME_TESTS
     #define RTL_TEST( expr ) rtl::impl::assert( expr, 0, #expr, __FILE__, __LINE__ )
 #else
@@ -45,13 +60,609 @@ namespace rtl
                 static_assert( pow_i( -1, -1 ) == -1 );
                 static_assert( pow_i( -1, 1 ) == -1 );
                 static_assert( pow_i( 2, -2 ) == 0 );
+                static_assert( pow_i( 2, 30 ) == 1 << 30 );
+                static_assert( pow_i( -3, 5 ) == -243 );
+                static_assert( pow_i( 7, 11 ) == 1977326743 );
+
+                static_assert( ceil_log2_i( 1 ) == 0 );
+                static_assert( ceil_log2_i( 2 ) == 1 );
+                static_assert( ceil_log2_i( 5 ) == 3 );
+                static_assert( ceil_log2_i( 1 << 30 ) == 30 );
+
+                static_assert( mul64( ~0ull, ~0ull ) == 1 );
+                static_assert( mul64( 0x123456789ull, 0xFEDCBA987ull )
+                               == 0x123456789ull * 0xFEDCBA987ull );
+                static_assert( mul64( 0x9E3779B97F4A7C15ull, 0xBF58476D1CE4E5B9ull )
+                               == 0x9E3779B97F4A7C15ull * 0xBF58476D1CE4E5B9ull );
             } // namespace math
 
+            namespace bit
+            {
+                static_assert( countl_zero( 0u ) == 32 );
+                static_assert( countl_zero( 1u ) == 31 );
+                static_assert( countl_zero( uint8_t( 0x10 ) ) == 3 );
+                static_assert( countl_zero( uint16_t( 0 ) ) == 16 );
+                static_assert( countl_zero( uint64_t( 1 ) << 40 ) == 23 );
+                static_assert( countl_zero( ~uint64_t( 0 ) ) == 0 );
+
+                static_assert( countr_zero( 0u ) == 32 );
+                static_assert( countr_zero( 0x80000000u ) == 31 );
+                static_assert( countr_zero( uint8_t( 0 ) ) == 8 );
+                static_assert( countr_zero( uint64_t( 1 ) << 63 ) == 63 );
+                static_assert( countr_zero( uint64_t( 0 ) ) == 64 );
+
+                static_assert( countl_one( 0xF0000000u ) == 4 );
+                static_assert( countr_one( uint8_t( 0x7F ) ) == 7 );
+
+                static_assert( popcount( 0u ) == 0 );
+                static_assert( popcount( 0xFFFFFFFFu ) == 32 );
+                static_assert( popcount( uint16_t( 0xA5A5 ) ) == 8 );
+                static_assert( popcount( uint64_t( 0x8000000100000001 ) ) == 3 );
+
+                static_assert( !has_single_bit( 0u ) );
+                static_assert( has_single_bit( 64u ) );
+                static_assert( !has_single_bit( 65u ) );
+
+                static_assert( bit_width( 0u ) == 0 );
+                static_assert( bit_width( 255u ) == 8 );
+                static_assert( bit_floor( 0u ) == 0 );
+                static_assert( bit_floor( 100u ) == 64 );
+                static_assert( bit_floor( uint64_t( 0x100000001 ) ) == uint64_t( 1 ) << 32 );
+                static_assert( bit_ceil( 0u ) == 1 );
+                static_assert( bit_ceil( 64u ) == 64 );
+                static_assert( bit_ceil( 65u ) == 128 );
+                static_assert( bit_ceil( uint64_t( 0x100000001 ) ) == uint64_t( 1 ) << 33 );
+
+                static_assert( rotl( 0x80000001u, 1 ) == 3u );
+                static_assert( rotl( 0x80000001u, 0 ) == 0x80000001u );
+                static_assert( rotl( 0x80000001u, -1 ) == 0xC0000000u );
+                static_assert( rotr( 0x80000001u, 1 ) == 0xC0000000u );
+                static_assert( rotl( uint8_t( 0x81 ), 4 ) == 0x18 );
+                static_assert( rotr( uint64_t( 1 ), 1 ) == uint64_t( 1 ) << 63 );
+                static_assert( rotl( uint64_t( 0x0123456789ABCDEF ), 32 ) == 0x89ABCDEF01234567 );
+
+                static_assert( byteswap( uint8_t( 0x12 ) ) == 0x12 );
+                static_assert( byteswap( uint16_t( 0x1234 ) ) == 0x3412 );
+                static_assert( byteswap( 0x12345678u ) == 0x78563412u );
+                static_assert( byteswap( uint64_t( 0x0123456789ABCDEF ) ) == 0xEFCDAB8967452301 );
+
+                // NOTE: native 64-bit shifts are fine in constant evaluation
+                constexpr bool shifts_by_halves()
+                {
+                    constexpr uint64_t x = 0x8123456789ABCDEF;
+
+                    for ( int n = 0; n < 64; ++n )
+                    {
+                        if ( impl::bit::shl64( x, n ) != x << n
+                             || impl::bit::shr64( x, n ) != x >> n )
+                        {
+                            return false;
+                        }
+                    }
+
+                    return true;
+                }
+
+                static_assert( shifts_by_halves() );
+            } // namespace bit
+
+            namespace fix
+            {
+                using fx = rtl::fix<int, 16>;
+
+                static_assert( fx( 300 ) * fx( 2 ) == fx( 600 ) );
+                static_assert( fx( 30000 ) * fx( 0.25f ) == fx( 7500 ) );
+                static_assert( fx( 30000 ) / fx( 0.5f ) == fx::from_raw( int( 60000u << 16 ) ) );
+                static_assert( fx( 1 ) / fx( 3 ) == fx::from_raw( 21845 ) );
+                static_assert( fx::from_raw( 3 ) * fx::from_raw( 0x8000 ) == fx::from_raw( 1 ) );
+
+                using fxn = rtl::fix<int,
+                                     16,
+                                     rtl::fix_policy<rtl::fix_rounding::nearest,
+                                                     rtl::fix_overflow::saturate>>;
+
+                static_assert( fxn::from_raw( 3 ) * fxn::from_raw( 0x8000 ) == fxn::from_raw( 2 ) );
+                static_assert( fxn( 2 ) / fxn( 3 ) == fxn::from_raw( 43691 ) );
+                static_assert( -fxn( 1 ) / fxn( 3 ) == fxn::from_raw( -21845 ) );
+                static_assert( fxn( 30000 ) * fxn( 30000 ) == fxn::max() );
+                static_assert( fxn( 30000 ) / fxn( 0.5f ) == fxn::max() );
+
+                static_assert( rtl::fix_math::reciprocal( fx( 4 ) ) == fx( 0.25f ) );
+                static_assert( rtl::fix_math::sqrt( fx( 4 ) ) == fx( 2 ) );
+                static_assert( rtl::fix_math::sin( fx( 0 ) ) == fx( 0 ) );
+                static_assert( rtl::fix_math::cos( fx( 0 ) ) == fx( 1 ) );
+                static_assert( rtl::fix_math::exp2( fx( 3 ) ) == fx( 8 ) );
+                static_assert( rtl::fix_math::log2( fx( 8 ) ) == fx( 3 ) );
+                static_assert( rtl::fix_math::atan2( fx( 1 ), fx( 0 ) )
+                               == fx::from_raw( rtl::impl::fix_math::tables<int, 16>::half_pi ) );
+            } // namespace fix
+
+            namespace random
+            {
+                // NOTE: reference values of the original implementations
+                static_assert( [] {
+                    rtl::pcg32 engine {};
+                    engine.init( 42, 54 );
+                    return engine.rand() == 0xa15c02b7u && engine.rand() == 0x7b47f409u;
+                }() );
+
+                static_assert( [] {
+                    rtl::splitmix64 engine {};
+                    engine.init( 1234567 );
+                    return engine.rand64() == 6457827717110365317ull
+                           && engine.rand64() == 3203168211198807973ull;
+                }() );
+
+                static_assert( [] {
+                    rtl::xoshiro256ss engine {};
+                    engine.init( 42 );
+                    return engine.rand() == 360188718u && engine.rand() == 1627707782u;
+                }() );
+
+                static_assert( [] {
+                    rtl::pcg32 a {};
+                    a.init( 1, 2 );
+                    rtl::pcg32 b = a;
+
+                    for ( int i = 0; i < 1000; ++i )
+                        (void)a.rand();
+
+                    b.advance( 1000 );
+                    return a.state == b.state;
+                }() );
+
+                static_assert( [] {
+                    rtl::pcg32 engine {};
+                    engine.init( 5 );
+
+                    const rtl::uniform_int<int> dice( 1, 6 );
+
+                    int counts[7] = {};
+                    for ( int i = 0; i < 600; ++i )
+                        ++counts[dice( engine )];
+
+                    return counts[0] == 0 && counts[1] > 0 && counts[6] > 0;
+                }() );
+
+                static_assert( impl::ziggurat::normal.k[1] == 0 );
+                static_assert( impl::ziggurat::normal.f[0] == 1.0f );
+                static_assert( impl::ziggurat::normal.f[127] < impl::ziggurat::normal.f[126] );
+            } // namespace random
+
+            namespace type_traits
+            {
+                struct pixel
+                {
+                    uint8_t b, g, r, a;
+                };
+
+                static_assert( rtl::is_integral_v<const unsigned char> );
+                static_assert( !rtl::is_integral_v<float> );
+                static_assert( rtl::is_trivially_copyable_v<pixel> );
+                static_assert( !rtl::is_trivially_copyable_v<rtl::string> );
+                static_assert( rtl::is_trivially_destructible_v<pixel> );
+                static_assert( !rtl::is_trivially_destructible_v<rtl::string> );
+            } // namespace type_traits
+
+            namespace algorithm
+            {
+                constexpr int copy_fill()
+                {
+                    int src[4] = { 1, 2, 3, 4 };
+                    int dst[4] = {};
+
+                    rtl::copy_n( src, 3, dst );
+                    rtl::fill_n( src, 2, 0 );
+
+                    return dst[0] + dst[2] + dst[3] + src[1] + src[2];
+                }
+
+                static_assert( copy_fill() == 7 );
+            } // namespace algorithm
+
+            namespace hash
+            {
+                static_assert( rtl::hash_bytes( "key", 3 ) != rtl::hash_bytes( "key", 3, 1 ) );
+                static_assert( rtl::hash<rtl::string_view>()( "a" )
+                               != rtl::hash<rtl::string_view>()( "b" ) );
+                static_assert( rtl::hash<int>()( 1 ) != rtl::hash<int>()( 2 ) );
+            } // namespace hash
+
+            namespace utf
+            {
+                static_assert( rtl::utf8_to_wide<char16_t>( "\xc3\xa9t\xc3\xa9", 5 ) == 3 );
+                static_assert( rtl::utf8_to_wide<char16_t>( "\xf0\x9f\x98\x80", 4 ) == 2 );
+                static_assert( rtl::utf8_to_wide<char32_t>( "\xf0\x9f\x98\x80", 4 ) == 1 );
+                static_assert( rtl::utf8_to_wide_checked( "\xc0\xaf", 2 ) == rtl::utf_error );
+                static_assert( rtl::wide_to_utf8( u"\u00e9t\u00e9", 3 ) == 5 );
+            } // namespace utf
+
+            namespace string
+            {
+                static_assert( rtl::string_view( "aab" ).find( "ab" ) == 1 );
+                static_assert( rtl::string_view( "abcabc" ).rfind( "abc" ) == 3 );
+                static_assert( rtl::string_view( "abcabc" ).find_first_of( "xc" ) == 2 );
+                static_assert( rtl::string_view( "abcabc" ).substr( 2, 3 ) == "cab" );
+                static_assert( rtl::string_view( "abc" ).substr( 1 ) == "bc" );
+            } // namespace string
+
+            namespace charconv
+            {
+                using rtl::impl::grisu::cached_powers;
+
+                static_assert( cached_powers::table[0].k == -300 );
+                static_assert( cached_powers::table[0].f == 0xAB70FE17C79AC6CAull );
+                static_assert( cached_powers::table[0].e == -1060 );
+                static_assert( cached_powers::table[38].k == 4 );
+                static_assert( cached_powers::table[38].f == 0x9C40000000000000ull );
+                static_assert( cached_powers::table[38].e == -50 );
+            } // namespace charconv
+
+            namespace fourcc
+            {
+                constexpr uint8_t code[] = { 'W', 'A', 'V', 'E' };
+
+                static_assert( rtl::make_fourcc( 'R', 'I', 'F', 'F' ) == 0x46464952 );
+                static_assert( rtl::make_fourcc( 0xFF, 0, 0, 0x80 ) == 0x800000FF );
+                static_assert( rtl::load_fourcc( code ) == rtl::make_fourcc( 'W', 'A', 'V', 'E' ) );
+            } // namespace fourcc
+
+            namespace filesystem
+            {
+                using rtl::filesystem::u8path_view;
+
+                static_assert( u8path_view( "dir/name.ext" ).filename() == "name.ext" );
+                static_assert( u8path_view( "dir/" ).filename() == "" );
+                static_assert( u8path_view( "dir/name.ext" ).stem() == "name" );
+                static_assert( u8path_view( "dir/name.ext" ).extension() == ".ext" );
+                static_assert( u8path_view( "a.tar.gz" ).extension() == ".gz" );
+                static_assert( u8path_view( "dir.d/name" ).extension() == "" );
+                static_assert( u8path_view( ".name" ).stem() == ".name" );
+                static_assert( u8path_view( ".name" ).extension() == "" );
+                static_assert( u8path_view( ".." ).extension() == "" );
+                static_assert( u8path_view( "name." ).extension() == "." );
+                static_assert( u8path_view( "a\\b//name" ).parent_path() == "a\\b" );
+                static_assert( u8path_view( "/name" ).parent_path() == "/" );
+                static_assert( u8path_view( "C:/name" ).parent_path() == "C:/" );
+                static_assert( u8path_view( "name" ).parent_path() == "" );
+            } // namespace filesystem
+
         } // namespace static_tests
 
 #if RTL_ENABLE_RUNTIME_TESTS
         namespace runtime_tests
         {
+            namespace bit
+            {
+                void run()
+                {
+                    // NOTE: intrinsics are taken at run time only, so check them against
+                    // the generic code used in constant evaluation
+                    bool same = true;
+
+                    for ( uint32_t i = 1, x = 0x9E3779B9u; i <= 64; ++i, x *= 0x2C1B3C6Du )
+                    {
+                        const uint32_t value = ( x >> ( i & 31 ) ) | 1;
+                        const int      shift = static_cast<int>( i & 31 );
+                        const uint32_t rotated
+                            = shift ? ( value << shift ) | ( value >> ( 32 - shift ) ) : value;
+
+                        same = same && countl_zero( value ) == impl::bit::clz32_generic( value );
+                        same = same && countr_zero( value ) == impl::bit::ctz32_generic( value );
+                        same = same && popcount( value ) == impl::bit::popcount32_generic( value );
+                        same = same && rotl( value, static_cast<int>( i ) ) == rotated;
+                    }
+
+                    RTL_TEST( same );
+
+                    volatile uint64_t wide = 0x0123456789ABCDEF;
+
+                    RTL_TEST( countl_zero( wide >> 20 ) == 27 );
+                    RTL_TEST( countr_zero( wide << 20 ) == 20 );
+                    RTL_TEST( popcount( uint64_t( wide ) ) == 32 );
+                    RTL_TEST( rotr( uint64_t( wide ), 4 ) == 0xF0123456789ABCDE );
+                    RTL_TEST( byteswap( uint64_t( wide ) ) == 0xEFCDAB8967452301 );
+                }
+            } // namespace bit
+
+            namespace fix
+            {
+                void run()
+                {
+                    using fx = rtl::fix<int, 16>;
+
+                    fx a[9], b[9], out[9];
+                    for ( int i = 0; i < 9; ++i )
+                    {
+                        a[i] = fx( i * 1000 );
+                        b[i] = fx( 0.5f );
+                    }
+
+                    rtl::batch::mul( a, b, rtl::span( out ) );
+                    RTL_TEST( out[0] == fx( 0 ) && out[8] == fx( 4000 ) );
+
+                    rtl::batch::mul_sat( a, a, rtl::span( out ) );
+                    RTL_TEST( out[0] == fx( 0 ) && out[1] == fx::max() && out[8] == fx::max() );
+
+                    rtl::batch::clamp( a, fx( 1500 ), fx( 6000 ), rtl::span( out ) );
+                    RTL_TEST( out[0] == fx( 1500 ) && out[3] == fx( 3000 ) );
+                    RTL_TEST( out[8] == fx( 6000 ) );
+
+                    rtl::batch::lerp( a, b, fx( 0.5f ), rtl::span( out ) );
+                    RTL_TEST( out[2] == fx( 1000 ) + fx( 0.25f ) );
+
+                    using fx8 = rtl::fix<short, 8>;
+
+                    fx8 c[11], d[11];
+                    for ( int i = 0; i < 11; ++i )
+                        c[i] = fx8( 100 );
+
+                    rtl::batch::add_sat( c, c, rtl::span( d ) );
+                    RTL_TEST( d[0] == fx8::max() && d[10] == fx8::max() );
+
+                    // NOTE: bit-exact values, any platform must reproduce them
+                    RTL_TEST( rtl::fix_math::reciprocal( -fx( 3 ) ).raw() == -21845 );
+                    RTL_TEST( rtl::fix_math::sqrt( fx( 2 ) ).raw() == 92682 );
+                    RTL_TEST( rtl::fix_math::sin( fx( 1 ) ).raw() == 55146 );
+                    RTL_TEST( rtl::fix_math::cos( -fx( 1 ) ).raw() == 35410 );
+                    RTL_TEST( rtl::fix_math::atan2( -fx( 1 ), -fx( 1 ) ).raw() == -154415 );
+                    RTL_TEST( rtl::fix_math::exp2( fx( 0.5f ) ).raw() == 92682 );
+                    RTL_TEST( rtl::fix_math::log2( fx( 3 ) ).raw() == 103872 );
+                    RTL_TEST( rtl::fix_math::reciprocal( fx( 0 ) ) == fx::max() );
+                }
+            } // namespace fix
+
+            namespace random
+            {
+                template<typename Engine>
+                bool fill_matches_rand( Engine engine )
+                {
+                    uint32_t values[11];
+
+                    Engine copy = engine;
+                    copy.fill( values );
+
+                    for ( uint32_t value : values )
+                        if ( value != engine.rand() )
+                            return false;
+
+                    return true;
+                }
+
+                void run()
+                {
+                    rtl::pcg32 pcg {};
+                    pcg.init( 7, 3 );
+                    RTL_TEST( fill_matches_rand( pcg ) );
+
+                    rtl::splitmix64 splitmix {};
+                    splitmix.init( 7 );
+                    RTL_TEST( fill_matches_rand( splitmix ) );
+
+                    rtl::xoshiro256ss xoshiro {};
+                    xoshiro.init( 7 );
+                    RTL_TEST( fill_matches_rand( xoshiro ) );
+
+                    // NOTE: the jump polynomial commutes with the state transition
+                    rtl::xoshiro256ss a = xoshiro;
+                    rtl::xoshiro256ss b = xoshiro;
+
+                    a.jump();
+                    (void)a.rand64();
+                    (void)b.rand64();
+                    b.jump();
+                    RTL_TEST( a.rand64() == b.rand64() && a.rand64() != xoshiro.rand64() );
+
+                    float      samples[256];
+                    rtl::pcg32 copy = pcg;
+
+                    const rtl::normal normal( 10.0f, 2.0f );
+                    normal.fill( pcg, samples );
+
+                    float sum = 0;
+                    for ( float sample : samples )
+                        sum += sample;
+
+                    RTL_TEST( sum > 256 * 9.5f && sum < 256 * 10.5f );
+                    RTL_TEST( normal( copy ) == samples[0] );
+
+                    using fx = rtl::fix<int, 16>;
+
+                    fx values[64];
+                    rtl::uniform_fix( -fx( 1 ), fx( 1 ) ).fill( pcg, rtl::span( values ) );
+
+                    bool in_range = true;
+                    for ( fx value : values )
+                        in_range = in_range && value >= -fx( 1 ) && value <= fx( 1 );
+
+                    RTL_TEST( in_range );
+                }
+            } // namespace random
+
+            namespace noise
+            {
+                void run()
+                {
+                    rtl::pcg32 engine {};
+                    engine.init( 1 );
+
+                    rtl::noise noise;
+                    noise.init( engine );
+
+                    // NOTE: lattice points of gradient noise are zero
+                    RTL_TEST( noise.perlin( 3.0f, 5.0f ) == 0.0f );
+                    RTL_TEST( noise.perlin( 3.0f, 5.0f, 7.0f ) == 0.0f );
+
+                    float row[11];
+                    noise.simplex_row( rtl::span( row ), -2.5f, 0.37f, 1.25f );
+
+                    bool same = true;
+                    for ( int i = 0; i < 11; ++i )
+                        same = same && row[i] == noise.simplex( -2.5f + 0.37f * i, 1.25f );
+
+                    RTL_TEST( same );
+
+                    using fx = rtl::fix<int, 16>;
+
+                    fx fix_row[7];
+                    noise.value_row(
+                        rtl::span( fix_row ), fx( 0.5f ), fx( 0.25f ), fx( 2 ), fx( 3 ) );
+
+                    bool in_range = true;
+                    for ( fx value : fix_row )
+                        in_range = in_range && value >= -fx( 1 ) && value <= fx( 1 );
+
+                    RTL_TEST( in_range );
+                    RTL_TEST( fix_row[0] == noise.value( fx( 0.5f ), fx( 2 ), fx( 3 ) ) );
+
+                    // NOTE: fix rows are scalar, they must give the bits of the point queries
+                    const fx x0( -2.5f );
+                    const fx dx( 0.37f );
+                    const fx y( 1.25f );
+                    const fx z( -3.0f );
+
+                    fx perlin_row[11];
+                    fx simplex_row[11];
+                    noise.perlin_row( rtl::span( perlin_row ), x0, dx, y, z );
+                    noise.simplex_row( rtl::span( simplex_row ), x0, dx, y );
+
+                    bool same_fix = true;
+                    for ( int i = 0; i < 11; ++i )
+                    {
+                        const fx x = x0 + dx * i;
+
+                        same_fix = same_fix && perlin_row[i] == noise.perlin( x, y, z )
+                                   && simplex_row[i] == noise.simplex( x, y );
+                    }
+
+                    RTL_TEST( same_fix );
+
+                    // A format with 7 integer bits still holds the lattice values
+                    using fx24 = rtl::fix<int, 24>;
+
+                    bool close = true;
+                    for ( int i = 0; i < 16; ++i )
+                    {
+                        const float x = 5.2f + 0.61f * i;
+                        const float y = 0.4f + 0.29f * i;
+                        const float error
+                            = static_cast<float>( noise.value( fx24( x ), fx24( y ) ) )
+                              - noise.value( x, y );
+
+                        close = close && error > -0.001f && error < 0.001f;
+                    }
+
+                    RTL_TEST( close );
+                }
+            } // namespace noise
+
+            namespace algorithm
+            {
+                void run()
+                {
+                    uint32_t pixels[37];
+                    rtl::fill( pixels, pixels + 37, 0xff00ff00u );
+                    RTL_TEST( pixels[0] == 0xff00ff00u && pixels[36] == 0xff00ff00u );
+
+                    rtl::fill_n( pixels + 1, 35, 0 );
+                    RTL_TEST( pixels[0] == 0xff00ff00u && pixels[1] == 0 && pixels[35] == 0 );
+                    RTL_TEST( pixels[36] == 0xff00ff00u );
+
+                    uint8_t bytes[21];
+                    rtl::fill_n( bytes, 21, 0x5a );
+                    RTL_TEST( bytes[0] == 0x5a && bytes[20] == 0x5a );
+
+                    uint32_t copy[37] = {};
+                    RTL_TEST( rtl::copy_n( pixels, 36, copy ) == copy + 36 );
+                    RTL_TEST( copy[0] == 0xff00ff00u && copy[35] == 0 && copy[36] == 0 );
+
+                    // Shifting towards the start, the way an element is erased
+                    uint32_t shifted[5] = { 1, 2, 3, 4, 5 };
+                    rtl::copy_n( shifted + 1, 4, shifted );
+                    RTL_TEST( shifted[0] == 2 && shifted[3] == 5 && shifted[4] == 5 );
+                }
+            } // namespace algorithm
+
+    #if RTL_ENABLE_MEMSET
+            namespace memory
+            {
+                // Sizes around the jump table, the vector paths and the 'rep' threshold
+                constexpr size_t counts[]
+                    = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 100, 2047, 2048, 3001 };
+
+                constexpr size_t offsets[] = { 0, 1, 7, 15 };
+                constexpr size_t shifts[] = { 1, 5, 16, 33 };
+
+                constexpr size_t buffer_size = 4096;
+
+                uint8_t g_buffer[buffer_size];
+                uint8_t g_expected[buffer_size];
+                uint8_t g_source[buffer_size];
+
+                void reset()
+                {
+                    for ( size_t i = 0; i < buffer_size; ++i )
+                    {
+                        g_buffer[i] = g_expected[i] = static_cast<uint8_t>( i * 7 + 3 );
+                        g_source[i] = static_cast<uint8_t>( i * 13 + 5 );
+                    }
+                }
+
+                // Also checks that nothing was written before or after the block
+                bool matches()
+                {
+                    for ( size_t i = 0; i < buffer_size; ++i )
+                    {
+                        if ( g_buffer[i] != g_expected[i] )
+                            return false;
+                    }
+
+                    return true;
+                }
+
+                void run()
+                {
+                    for ( size_t count : counts )
+                    {
+                        for ( size_t offset : offsets )
+                        {
+                            uint8_t* block = g_buffer + offset;
+                            uint8_t* expected = g_expected + offset;
+
+                            reset();
+                            ::memset( block, 0xA5, count );
+                            for ( size_t i = 0; i < count; ++i )
+                                expected[i] = 0xA5;
+                            RTL_TEST( matches() );
+
+                            reset();
+                            ::memcpy( block, g_source + 3, count );
+                            for ( size_t i = 0; i < count; ++i )
+                                expected[i] = g_source[3 + i];
+                            RTL_TEST( matches() );
+
+                            for ( size_t shift : shifts )
+                            {
+                                // Towards lower addresses, the way a container erases
+                                reset();
+                                ::memmove( block, block + shift, count );
+                                for ( size_t i = 0; i < count; ++i )
+                                    expected[i] = expected[i + shift];
+                                RTL_TEST( matches() );
+
+                                // Towards higher addresses, the way a container inserts
+                                reset();
+                                ::memmove( block + shift, block, count );
+                                for ( size_t i = count; i > 0; --i )
+                                    expected[i - 1 + shift] = expected[i - 1];
+                                RTL_TEST( matches() );
+                            }
+                        }
+                    }
+                }
+            } // namespace memory
+    #endif
+
             namespace string
             {
                 void run()
@@ -65,14 +676,975 @@ namespace rtl
                     RTL_TEST( s.size() == 8 );
                     RTL_TEST( s.rfind( ".ext" ) == 4 );
 
-                    rtl::string_view sext = s.substr( 4, rtl::string::npos );
+                    const rtl::string ext = s.substr( 4, rtl::string::npos );
+                    rtl::string_view  sext = ext;
                     RTL_TEST( sext.size() == 4 );
                     RTL_TEST( sext == ".ext" );
+
+                    rtl::string_view text( "aab, abcabcabd" );
+                    RTL_TEST( text.find( "ab" ) == 1 );
+                    RTL_TEST( text.find( "abcabd" ) == 8 );
+                    RTL_TEST( text.find( "abd", 12 ) == rtl::string_view::npos );
+                    RTL_TEST( text.find( "" ) == 0 );
+                    RTL_TEST( text.rfind( "abc" ) == 8 );
+                    RTL_TEST( text.rfind( "abc", 7 ) == 5 );
+                    RTL_TEST( text.rfind( 'a' ) == 11 );
+                    RTL_TEST( text.find_first_of( ", " ) == 3 );
+
+                    const rtl::string copy = s;
+                    RTL_TEST( copy == "name.ext" && copy.c_str()[8] == 0 );
+                    RTL_TEST( rtl::string( 3, 'x' ) == "xxx" );
+
+                    rtl::wstring_view wtext( L"archive.tar.gz" );
+                    RTL_TEST( wtext.rfind( L"." ) == 11 );
+                    RTL_TEST( wtext.find( L"tar" ) == 8 );
                 }
             } // namespace string
 
+            namespace utf
+            {
+                void run()
+                {
+                    // "Привет, world!" spans the ASCII fast path and multibyte sequences
+                    const char text[] = "\xd0\x9f\xd1\x80\xd0\xb8\xd0\xb2\xd0\xb5\xd1\x82, "
+                                        "world! Plain ASCII tail to cross a 16-byte block";
+
+                    const rtl::wstring wide = rtl::utf8_to_wide( text );
+                    RTL_TEST( wide.size() == sizeof( text ) - 1 - 6 );
+                    RTL_TEST( wide.data()[0] == 0x41f && wide.data()[6] == L',' );
+                    RTL_TEST( rtl::wide_to_utf8( wide ) == text );
+
+                    wchar_t buffer[4];
+                    RTL_TEST( rtl::utf8_to_wide( "a\xffz", 3, buffer ) == 3 );
+                    RTL_TEST( buffer[1] == 0xfffd && buffer[2] == L'z' );
+                    RTL_TEST( rtl::utf8_to_wide_checked( "a\xffz", 3 ) == rtl::utf_error );
+
+                    const rtl::filesystem::path p( rtl::string_view( "dir/\xc3\xa9.txt" ) );
+                    RTL_TEST( p.wstring() == L"dir/\u00e9.txt" );
+                    RTL_TEST( p.u8string() == "dir/\xc3\xa9.txt" );
+                }
+            } // namespace utf
+
+            namespace hash
+            {
+                void run()
+                {
+                    constexpr uint64_t text = rtl::hash_bytes( L"hash me, please", 15 );
+
+                    const rtl::wstring copy( L"hash me, please" );
+                    RTL_TEST( rtl::hash_bytes( copy.data(), copy.size() ) == text );
+                    const void* raw = copy.c_str();
+                    RTL_TEST( rtl::hash_bytes( raw, copy.size() * sizeof( wchar_t ) ) == text );
+
+                    uint8_t bytes[100] = {};
+                    uint64_t hashes[101];
+                    for ( size_t i = 0; i <= 100; ++i )
+                        hashes[i] = rtl::hash_bytes( bytes, i );
+
+                    for ( size_t i = 0; i < 100; ++i )
+                        RTL_TEST( hashes[i] != hashes[i + 1] );
+
+                    const rtl::filesystem::path p( L"dir\\name.ext" );
+                    RTL_TEST( rtl::hash<rtl::filesystem::path>()( p )
+                              == rtl::hash<rtl::wstring_view>()( L"dir\\name.ext" ) );
+
+                    int                   values[2] = {};
+                    const rtl::hash<int*> pointer_hash;
+                    RTL_TEST( pointer_hash( values ) == pointer_hash( &values[0] ) );
+                    RTL_TEST( pointer_hash( values ) != pointer_hash( values + 1 ) );
+                    RTL_TEST( rtl::hash<const int*>()( values ) == pointer_hash( values ) );
+                }
+            } // namespace hash
+
+            namespace charconv
+            {
+                template<typename Float>
+                bool test( Float value, const char* expected )
+                {
+                    char buffer[32];
+
+                    const auto result = rtl::to_chars( buffer, buffer + 32, value );
+
+                    return result.ec == rtl::errc::ok
+                           && rtl::string_view( buffer, (size_t)( result.ptr - buffer ) )
+                                  == expected;
+                }
+
+                void run()
+                {
+                    RTL_TEST( test( 0.0, "0" ) );
+                    RTL_TEST( test( -0.0, "-0" ) );
+                    RTL_TEST( test( 0.1, "0.1" ) );
+                    RTL_TEST( test( 100.0, "100" ) );
+                    RTL_TEST( test( 123.456, "123.456" ) );
+                    RTL_TEST( test( 0.001, "0.001" ) );
+                    RTL_TEST( test( 0.0001, "1e-04" ) );
+                    RTL_TEST( test( 1e21, "1e+21" ) );
+                    RTL_TEST( test( 5e-324, "5e-324" ) );
+                    RTL_TEST( test( 1.7976931348623157e308, "1.7976931348623157e+308" ) );
+                    RTL_TEST( test( 0.3f, "0.3" ) );
+                    RTL_TEST( test( -1.5f, "-1.5" ) );
+
+                    wchar_t    wbuffer[3];
+                    const auto result = rtl::to_chars( wbuffer, wbuffer + 3, 12.5 );
+                    RTL_TEST( result.ec == rtl::errc::value_too_large );
+                }
+            } // namespace charconv
+
+            namespace archive
+            {
+                void run()
+                {
+                    // Files "a" and "b/c", laid out the way rtl_pack does it
+                    struct image
+                    {
+                        rtl::archive_header header;
+                        rtl::archive_entry  entries[2];
+                        char                names[4];
+                        uint8_t             data[4];
+                    };
+
+                    constexpr uint32_t data_offset = sizeof( rtl::archive_header )
+                                                     + sizeof( rtl::archive_entry ) * 2 + 4;
+
+                    const image bytes = {
+                        { rtl::archive_magic, rtl::archive_version, 2, 4 },
+                        { { 0, 1, rtl::make_fourcc( 'T', 'X', 'T', ' ' ), data_offset, 1 },
+                          { 1, 3, 0, data_offset + 1, 3 } },
+                        { 'a', 'b', '/', 'c' },
+                        { 'x', 'y', 'z', 'w' } };
+
+                    static_assert( sizeof( image ) == data_offset + 4 );
+
+                    const uint8_t* data = reinterpret_cast<const uint8_t*>( &bytes );
+
+                    rtl::archive a( rtl::span<const uint8_t>( data, sizeof( bytes ) ) );
+                    RTL_TEST( a.is_open() );
+                    RTL_TEST( a.size() == 2 );
+
+                    rtl::archive::file file;
+                    RTL_TEST( a.find( "b/c", file ) );
+                    RTL_TEST( file.data.size() == 3 && file.data[0] == 'y' );
+                    RTL_TEST( a.find( "a", file ) );
+                    RTL_TEST( file.type == rtl::make_fourcc( 'T', 'X', 'T', ' ' ) );
+                    RTL_TEST( a.find( "b", file ) == false );
+
+                    RTL_TEST( a.open( rtl::span<const uint8_t>( data, data_offset ) ) == false );
+                }
+            } // namespace archive
+
+            namespace riff
+            {
+                void run()
+                {
+                    // WAV file with an odd-sized chunk and a data chunk whose size is too large
+                    const uint8_t wav[] = { 'R', 'I', 'F', 'F', 26, 0, 0, 0, 'W', 'A', 'V', 'E',
+                                            'f', 'm', 't', ' ', 3,  0, 0, 0, 1,   2,   3,   0,
+                                            'd', 'a', 't', 'a', 99, 0, 0, 0, 4,   5 };
+
+                    const rtl::riff_chunks file( wav );
+
+                    rtl::riff_chunk root;
+                    RTL_TEST( file.find( rtl::make_fourcc( 'R', 'I', 'F', 'F' ), root ) );
+                    RTL_TEST( root.is_list() );
+                    RTL_TEST( root.form() == rtl::make_fourcc( 'W', 'A', 'V', 'E' ) );
+                    RTL_TEST( root.data.size() == 26 );
+
+                    size_t count = 0;
+                    for ( const rtl::riff_chunk& chunk : file.children( root ) )
+                    {
+                        RTL_TEST( !chunk.is_list() );
+                        ++count;
+                    }
+                    RTL_TEST( count == 2 );
+
+                    rtl::riff_chunk chunk;
+                    RTL_TEST( file.children( root ).find( rtl::make_fourcc( 'd', 'a', 't', 'a' ),
+                                                          chunk ) );
+                    RTL_TEST( chunk.data.size() == 2 && chunk.data[0] == 4 );
+                    RTL_TEST( file.children( root ).find( rtl::make_fourcc( 'f', 'm', 't', ' ' ),
+                                                          chunk ) );
+                    RTL_TEST( chunk.data.size() == 3 && chunk.data[2] == 3 );
+                    RTL_TEST( file.children( root ).find( rtl::make_fourcc( 'L', 'I', 'S', 'T' ),
+                                                          chunk )
+                              == false );
+
+                    // IFF sizes are big-endian, a trailing partial header is ignored
+                    const uint8_t aiff[] = { 'F', 'O', 'R', 'M', 0, 0, 0, 4, 'A', 'I', 'F', 'F',
+                                             'C', 'O' };
+
+                    const rtl::riff_chunks form( aiff, rtl::riff_endian::big );
+
+                    count = 0;
+                    for ( const rtl::riff_chunk& c : form )
+                    {
+                        RTL_TEST( c.form() == rtl::make_fourcc( 'A', 'I', 'F', 'F' ) );
+                        RTL_TEST( form.children( c ).begin() == form.children( c ).end() );
+                        ++count;
+                    }
+                    RTL_TEST( count == 1 );
+                }
+            } // namespace riff
+
+            namespace lz4
+            {
+                void run()
+                {
+                    // "abc", then a 12 byte match at offset 3, then the last literals "xyzab"
+                    const uint8_t block[]
+                        = { 0x38, 'a', 'b', 'c', 3, 0, 0x50, 'x', 'y', 'z', 'a', 'b' };
+
+                    uint8_t output[24];
+
+                    RTL_TEST( rtl::lz4_decompress( block, output ) == 20 );
+                    RTL_TEST( rtl::string_view( reinterpret_cast<const char*>( output ), 20 )
+                              == "abcabcabcabcabcxyzab" );
+
+                    // Output does not fit
+                    RTL_TEST( rtl::lz4_decompress( block, rtl::span<uint8_t>( output, 19 ) ) == 0 );
+
+                    // Match before the start of the output
+                    const uint8_t corrupted[] = { 0x38, 'a', 'b', 'c', 4, 0 };
+                    RTL_TEST( rtl::lz4_decompress( corrupted, output ) == 0 );
+
+                    // Empty input encodes as a single token with no literals and no match
+                    const uint8_t empty[] = { 0x00 };
+                    RTL_TEST( rtl::lz4_decompress( empty, rtl::span<uint8_t>() ) == 0 );
+                }
+            } // namespace lz4
+
             namespace filesystem
             {
+                using rtl::filesystem::path;
+
+                // Directory in the temp folder for the tests that need real files
+                path scratch_directory()
+                {
+                    wchar_t     temp[MAX_PATH + 1];
+                    const DWORD length = ::GetTempPathW( MAX_PATH + 1, temp );
+                    RTL_TEST( length > 0 && length <= MAX_PATH );
+
+                    path directory( rtl::filesystem::path_view( rtl::wstring_view( temp, length ) )
+                                    / L"rtl_tests" );
+
+                    // NOTE: may be left over from an interrupted run
+                    ::CreateDirectoryW( directory.c_str(), nullptr );
+
+                    return directory;
+                }
+
+                bool write_file( const path& p, const void* data, size_t size )
+                {
+                    rtl::filesystem::file_writer writer( p );
+                    return writer.write( data, size ) && writer.commit();
+                }
+
+                bool write_file( const path& p, rtl::string_view content )
+                {
+                    return write_file( p, content.data(), content.size() );
+                }
+
+                void test_mapped_file( const path& directory )
+                {
+                    using rtl::filesystem::mapped_file;
+
+                    const path name = directory / L"mapped.txt";
+                    RTL_TEST( write_file( name, "mapped file content" ) );
+
+                    mapped_file file( name );
+                    RTL_TEST( file.is_open() );
+                    RTL_TEST( file.view() == "mapped file content" );
+                    file.prefetch( 3, 7 );
+                    file.close();
+
+                    mapped_file writable( name, mapped_file::mode::read_write );
+                    RTL_TEST( writable.size() == 19 );
+                    writable.writable_data()[0] = 'M';
+                    RTL_TEST( writable.flush() );
+                    writable.close();
+
+                    RTL_TEST( file.open( name, mapped_file::mode::read_only ) );
+                    RTL_TEST( file.view() == "Mapped file content" );
+                    file.close();
+
+                    // NOTE: an empty file is open, but has no view
+                    const path empty = directory / L"empty.txt";
+                    RTL_TEST( write_file( empty, "" ) );
+                    RTL_TEST( file.open( empty ) );
+                    RTL_TEST( file.size() == 0 && file.view().empty() );
+                    file.prefetch();
+                    file.close();
+
+                    ::DeleteFileW( name.c_str() );
+                    ::DeleteFileW( empty.c_str() );
+                }
+
+                // Byte of a generated file at an offset
+                uint8_t pattern( size_t offset )
+                {
+                    return static_cast<uint8_t>( offset * 31 + offset / 256 );
+                }
+
+                bool has_content( const path& p, const uint8_t* data, size_t size )
+                {
+                    rtl::filesystem::mapped_file file( p );
+
+                    if ( !file.is_open() || file.size() != size )
+                        return false;
+
+                    for ( size_t i = 0; i < size; ++i )
+                    {
+                        if ( file.data()[i] != data[i] )
+                            return false;
+                    }
+
+                    return true;
+                }
+
+                void test_file_writer( const path& directory )
+                {
+                    using rtl::filesystem::directory_entry;
+                    using rtl::filesystem::file_writer;
+
+                    // NOTE: the small buffer takes every path of write(): buffered, filled up,
+                    // and direct
+                    constexpr size_t buffer_size = 16;
+                    constexpr size_t block_size = 40;
+
+                    uint8_t block[block_size];
+                    for ( size_t i = 0; i < block_size; ++i )
+                        block[i] = pattern( i );
+
+                    const uint8_t             head[] = { 'a', 'b' };
+                    const uint8_t             tail[] = { 'c', 'd' };
+                    const span<const uint8_t> pieces[] = { head, block, tail };
+
+                    // A mode marker, the block, and the gather write of the pieces
+                    constexpr size_t total = 1 + block_size + 2 + block_size + 2;
+
+                    uint8_t expected[total];
+                    expected[0] = 'T';
+                    rtl::copy_n( block, block_size, expected + 1 );
+                    rtl::copy_n( head, 2, expected + 1 + block_size );
+                    rtl::copy_n( block, block_size, expected + 3 + block_size );
+                    rtl::copy_n( tail, 2, expected + 3 + block_size * 2 );
+
+                    const path name = directory / L"writer.bin";
+                    const path temporary = directory / L"writer.bin.tmp";
+
+                    const file_writer::mode modes[] = { file_writer::mode::truncate,
+                                                        file_writer::mode::atomic };
+
+                    for ( file_writer::mode m : modes )
+                    {
+                        const uint8_t marker = m == file_writer::mode::atomic ? 'A' : 'T';
+
+                        file_writer writer;
+                        RTL_TEST( writer.open( name, m, buffer_size ) );
+                        RTL_TEST( writer.write( &marker, 1 ) );
+                        RTL_TEST( writer.write( span<const uint8_t>( block ) ) );
+                        RTL_TEST( writer.write( pieces ) );
+                        RTL_TEST( writer.size() == total );
+
+                        // The target keeps the content of the truncate pass until the commit
+                        if ( m == file_writer::mode::atomic )
+                        {
+                            RTL_TEST( directory_entry( temporary ).exists() );
+                            RTL_TEST( has_content( name, expected, total ) );
+                        }
+
+                        expected[0] = marker;
+
+                        RTL_TEST( writer.commit() );
+                        RTL_TEST( writer.is_open() == false );
+                        RTL_TEST( writer.failed() == false );
+                        RTL_TEST( has_content( name, expected, total ) );
+                        RTL_TEST( directory_entry( temporary ).exists() == false );
+                    }
+
+                    // An atomic write closed without a commit is discarded
+                    {
+                        file_writer writer( name, file_writer::mode::atomic, buffer_size );
+                        RTL_TEST( writer.write( block, block_size ) );
+                        RTL_TEST( writer.flush() );
+                        RTL_TEST( directory_entry( temporary ).exists() );
+                        writer.close();
+                        RTL_TEST( writer.is_open() == false );
+                    }
+
+                    RTL_TEST( has_content( name, expected, total ) );
+                    RTL_TEST( directory_entry( temporary ).exists() == false );
+
+                    ::DeleteFileW( name.c_str() );
+                }
+
+                void test_file_cache( const path& directory )
+                {
+                    using rtl::filesystem::file_cache;
+                    using rtl::filesystem::file_writer;
+
+                    constexpr size_t map_threshold = 16;
+                    constexpr size_t large_size = 80;
+
+                    uint8_t content[large_size];
+                    for ( size_t i = 0; i < large_size; ++i )
+                        content[i] = pattern( i );
+
+                    const path small = directory / L"cached.txt";
+                    const path large = directory / L"cached.bin";
+                    RTL_TEST( write_file( small, "tiny" ) );
+                    RTL_TEST( write_file( large, content, large_size / 2 ) );
+
+                    file_cache cache( 1024, map_threshold );
+                    RTL_TEST( cache.get( small ).size() == 4 );
+                    RTL_TEST( cache.get( large ).size() == large_size / 2 );
+                    RTL_TEST( cache.get( small ).size() == 4 );
+                    RTL_TEST( cache.stats().hits == 1 && cache.stats().misses == 2 );
+
+                    // The mapped file is written in place while the cache holds it open
+                    HANDLE file = ::CreateFileW( large.c_str(),
+                                                 GENERIC_WRITE,
+                                                 FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                                 nullptr,
+                                                 OPEN_EXISTING,
+                                                 FILE_ATTRIBUTE_NORMAL,
+                                                 nullptr );
+                    RTL_TEST( file != INVALID_HANDLE_VALUE );
+
+                    if ( file != INVALID_HANDLE_VALUE )
+                    {
+                        DWORD written = 0;
+                        RTL_TEST( ::WriteFile( file, "X", 1, &written, nullptr ) && written == 1 );
+                        ::CloseHandle( file );
+                    }
+
+                    const span<const uint8_t> changed = cache.get( large );
+                    RTL_TEST( changed.size() == large_size / 2 && changed[0] == 'X' );
+
+                    // NOTE: a mapped view blocks replacing the file, the entry is dropped first
+                    cache.clear();
+
+                    {
+                        file_writer writer( large, file_writer::mode::atomic );
+                        RTL_TEST( writer.write( content, large_size ) );
+                        RTL_TEST( writer.commit() );
+                    }
+
+                    const span<const uint8_t> replaced = cache.get( large );
+                    const size_t              last = large_size - 1;
+                    RTL_TEST( replaced.size() == large_size && replaced[last] == content[last] );
+
+                    cache.clear();
+                    ::DeleteFileW( large.c_str() );
+                    ::DeleteFileW( small.c_str() );
+                }
+
+                void test_stream_reader( const path& directory )
+                {
+                    // Five whole chunks and an odd tail
+                    constexpr size_t chunk_size = 64;
+                    constexpr size_t file_size = chunk_size * 5 + 13;
+
+                    uint8_t content[file_size];
+                    for ( size_t i = 0; i < file_size; ++i )
+                        content[i] = pattern( i );
+
+                    const path name = directory / L"stream.bin";
+                    RTL_TEST( write_file( name, content, file_size ) );
+
+                    for ( int buffers = 2; buffers <= 3; ++buffers )
+                    {
+                        rtl::filesystem::stream_reader reader( name, chunk_size, buffers );
+                        RTL_TEST( reader.is_open() );
+                        RTL_TEST( reader.file_size() == file_size );
+
+                        size_t offset = 0;
+                        bool   same = true;
+
+                        for ( span<const uint8_t> chunk = reader.next(); !chunk.empty();
+                              chunk = reader.next() )
+                        {
+                            RTL_TEST( reader.position() == offset );
+                            RTL_TEST( chunk.size() == rtl::min( chunk_size, file_size - offset ) );
+
+                            for ( size_t i = 0; i < chunk.size(); ++i )
+                                same = same && chunk[i] == pattern( offset + i );
+
+                            offset += chunk.size();
+                        }
+
+                        RTL_TEST( same );
+                        RTL_TEST( offset == file_size );
+                        RTL_TEST( reader.failed() == false );
+
+                        // NOTE: end of file stays the end of file
+                        RTL_TEST( reader.next().empty() );
+                        RTL_TEST( reader.failed() == false );
+                    }
+
+                    ::DeleteFileW( name.c_str() );
+                }
+
+                void test_directory_iterator( const path& directory )
+                {
+                    using rtl::filesystem::directory_entry;
+                    using rtl::filesystem::directory_iterator;
+
+                    const path list = directory / L"list";
+                    const path text = list / L"a.txt";
+                    const path empty = list / L"b.bin";
+                    const path sub = list / L"c";
+
+                    RTL_TEST( ::CreateDirectoryW( list.c_str(), nullptr ) );
+                    RTL_TEST( write_file( text, "12345" ) );
+                    RTL_TEST( write_file( empty, "" ) );
+                    RTL_TEST( ::CreateDirectoryW( sub.c_str(), nullptr ) );
+
+                    int  found = 0;
+                    bool same = true;
+
+                    for ( directory_iterator it( list ), end; it != end; ++it )
+                    {
+                        const directory_entry& entry = *it;
+
+                        // NOTE: "." and ".." are skipped, so every entry is one of the three
+                        const bool known
+                            = entry.path() == text || entry.path() == empty || entry.path() == sub;
+                        RTL_TEST( known );
+
+                        const directory_entry queried( entry.path() );
+                        same = same && entry.file_size() == queried.file_size()
+                               && entry.last_write_time() == queried.last_write_time()
+                               && entry.is_directory() == queried.is_directory();
+
+                        if ( entry.path() == text )
+                            RTL_TEST( entry.file_size() == 5 && entry.last_write_time() != 0 );
+
+                        if ( entry.path() == sub )
+                            RTL_TEST( entry.is_directory() );
+
+                        ++found;
+                    }
+
+                    RTL_TEST( found == 3 );
+                    RTL_TEST( same );
+
+                    ::DeleteFileW( text.c_str() );
+                    ::DeleteFileW( empty.c_str() );
+                    ::RemoveDirectoryW( sub.c_str() );
+                    ::RemoveDirectoryW( list.c_str() );
+                }
+
+                // Tree of the recursive listing tests, directories come before their content
+                struct tree
+                {
+                    explicit tree( const path& directory )
+                        : root( directory / L"tree" )
+                        , nodes{ { root / L"a.png", 0, false },
+                                 { root / L"b.txt", 0, false },
+                                 { root / L"d1", 0, true },
+                                 { root / L"d1/c.PNG", 1, false },
+                                 { root / L"d1/d2", 1, true },
+                                 { root / L"d1/d2/e.png", 2, false },
+                                 { root / L"skip", 0, true },
+                                 { root / L"skip/f.png", 1, false } }
+                    {
+                        RTL_TEST( ::CreateDirectoryW( root.c_str(), nullptr ) );
+
+                        for ( const node& n : nodes )
+                        {
+                            if ( n.directory )
+                                RTL_TEST( ::CreateDirectoryW( n.name.c_str(), nullptr ) );
+                            else
+                                RTL_TEST( write_file( n.name, "tree" ) );
+                        }
+                    }
+
+                    ~tree()
+                    {
+                        for ( int i = count; i > 0; --i )
+                        {
+                            const node& n = nodes[i - 1];
+
+                            if ( n.directory )
+                                ::RemoveDirectoryW( n.name.c_str() );
+                            else
+                                ::DeleteFileW( n.name.c_str() );
+                        }
+
+                        ::RemoveDirectoryW( root.c_str() );
+                    }
+
+                    // Index of the node, -1 for a path out of the tree
+                    int find( const path& p ) const
+                    {
+                        for ( int i = 0; i < count; ++i )
+                        {
+                            if ( nodes[i].name == p )
+                                return i;
+                        }
+
+                        return -1;
+                    }
+
+                    struct node
+                    {
+                        path name;
+                        int  depth;
+                        bool directory;
+                    };
+
+                    static constexpr int count = 8;
+
+                    path root;
+                    node nodes[count];
+                };
+
+                void test_recursive_directory_iterator( const path& directory )
+                {
+                    using rtl::filesystem::recursive_directory_iterator;
+
+                    const tree t( directory );
+
+                    bool seen[tree::count] = {};
+                    bool same = true;
+
+                    for ( recursive_directory_iterator it( t.root ), end; it != end; ++it )
+                    {
+                        const int i = t.find( ( *it ).path() );
+                        RTL_TEST( i >= 0 && !seen[i] );
+
+                        if ( i >= 0 )
+                        {
+                            seen[i] = true;
+                            same = same && it.depth() == t.nodes[i].depth;
+                        }
+                    }
+
+                    RTL_TEST( same );
+
+                    for ( bool s : seen )
+                        RTL_TEST( s );
+
+                    // Neither "skip" nor the rest of "d1" after its first entry is listed
+                    int  listed = 0;
+                    int  in_d1 = 0;
+                    bool in_skip = false;
+
+                    for ( recursive_directory_iterator it( t.root ), end; it != end; )
+                    {
+                        const int i = t.find( ( *it ).path() );
+                        ++listed;
+
+                        if ( i == 6 )
+                            it.disable_recursion_pending();
+
+                        in_skip = in_skip || i == 7;
+
+                        if ( i == 3 || i == 4 )
+                        {
+                            ++in_d1;
+                            it.pop();
+                            RTL_TEST( it == end || it.depth() == 0 );
+                            continue;
+                        }
+
+                        ++it;
+                    }
+
+                    RTL_TEST( listed == 5 );
+                    RTL_TEST( in_d1 == 1 );
+                    RTL_TEST( in_skip == false );
+                }
+
+                void test_walk( const path& directory )
+                {
+                    using rtl::filesystem::walk_entry;
+
+                    const tree t( directory );
+
+                    struct totals
+                    {
+                        volatile LONG entries;
+                        volatile LONG depths;
+                    };
+
+                    rtl::filesystem::walk_options options;
+
+                    auto visitor = []( const walk_entry& entry, void* context )
+                    {
+                        totals& result = *static_cast<totals*>( context );
+                        ::InterlockedIncrement( &result.entries );
+                        ::InterlockedExchangeAdd( &result.depths, entry.depth );
+                    };
+
+                    constexpr int thread_counts[] = { 1, 4 };
+
+                    for ( int threads : thread_counts )
+                    {
+                        // a.png, c.PNG, e.png and f.png
+                        totals png = {};
+                        options.extension = L".png";
+                        options.directories = false;
+                        options.threads = threads;
+                        rtl::filesystem::walk( t.root, visitor, &png, options );
+                        RTL_TEST( png.entries == 4 && png.depths == 4 );
+
+                        // d1, d2, skip and b.txt
+                        totals text = {};
+                        options.extension = L".txt";
+                        options.directories = true;
+                        rtl::filesystem::walk( t.root, visitor, &text, options );
+                        RTL_TEST( text.entries == 4 && text.depths == 1 );
+                    }
+                }
+
+                // Events of test_watcher by action and name, names are only valid during poll
+                struct watch_log
+                {
+                    static constexpr int name_count = 5;
+
+                    void operator()( const rtl::filesystem::watch_event& event )
+                    {
+                        const int name = find( event.name );
+                        const int old_name = find( event.old_name );
+
+                        if ( count < 32 && name >= 0 )
+                            entries[count++] = { event.action, name, old_name };
+                    }
+
+                    int find( wstring_view name ) const
+                    {
+                        for ( int i = 0; i < name_count; ++i )
+                        {
+                            if ( name == names[i] )
+                                return i;
+                        }
+
+                        return -1;
+                    }
+
+                    int events( rtl::filesystem::watch_action action, int name ) const
+                    {
+                        int result = 0;
+
+                        for ( int i = 0; i < count; ++i )
+                            result += entries[i].action == action && entries[i].name == name;
+
+                        return result;
+                    }
+
+                    int events( int name ) const
+                    {
+                        int result = 0;
+
+                        for ( int i = 0; i < count; ++i )
+                            result += entries[i].name == name;
+
+                        return result;
+                    }
+
+                    struct entry
+                    {
+                        rtl::filesystem::watch_action action;
+                        int                           name;
+                        int                           old_name;
+                    };
+
+                    const wstring_view names[name_count] = {
+                        L"first.txt", L"temp.txt", L"keep.txt", L"old.txt", L"new.txt"
+                    };
+
+                    entry entries[32] = {};
+                    int   count = 0;
+                };
+
+                void test_watcher( const path& directory )
+                {
+                    using rtl::filesystem::watch_action;
+
+                    enum
+                    {
+                        first,
+                        temp,
+                        keep,
+                        old,
+                        renamed
+                    };
+
+                    const path watched = directory / L"watch";
+                    RTL_TEST( ::CreateDirectoryW( watched.c_str(), nullptr ) );
+
+                    watch_log                log;
+                    rtl::filesystem::watcher w( watched, false );
+                    RTL_TEST( w.is_open() );
+
+                    path files[watch_log::name_count];
+                    for ( int i = 0; i < watch_log::name_count; ++i )
+                        files[i] = watched / log.names[i];
+
+                    // NOTE: the first change completes the pending request on its own, the
+                    // following ones are collected into one batch
+                    RTL_TEST( write_file( files[first], "1" ) );
+                    RTL_TEST( write_file( files[temp], "2" ) );
+                    RTL_TEST( write_file( files[keep], "3" ) );
+                    RTL_TEST( write_file( files[old], "4" ) );
+                    RTL_TEST( ::MoveFileExW( files[old].c_str(), files[renamed].c_str(), 0 ) );
+                    RTL_TEST( ::DeleteFileW( files[temp].c_str() ) );
+                    RTL_TEST( write_file( files[keep], "33" ) );
+
+                    while ( w.poll( log, 0 ) > 0 )
+                        ;
+
+                    // The short-lived file is dropped and the changes of another are folded
+                    RTL_TEST( log.events( temp ) == 0 );
+                    RTL_TEST( log.events( keep ) == 1 );
+                    RTL_TEST( log.events( watch_action::created, keep ) == 1 );
+                    RTL_TEST( log.events( watch_action::created, first ) == 1 );
+                    RTL_TEST( log.events( watch_action::created, old ) == 1 );
+                    RTL_TEST( log.events( renamed ) == 1 );
+                    RTL_TEST( log.events( watch_action::renamed, renamed ) == 1 );
+
+                    bool renamed_from_old = false;
+                    for ( int i = 0; i < log.count; ++i )
+                        renamed_from_old = renamed_from_old || log.entries[i].old_name == old;
+
+                    RTL_TEST( renamed_from_old );
+
+                    log.count = 0;
+
+                    RTL_TEST( ::DeleteFileW( files[first].c_str() ) );
+                    RTL_TEST( ::DeleteFileW( files[keep].c_str() ) );
+                    RTL_TEST( ::DeleteFileW( files[renamed].c_str() ) );
+
+                    while ( w.poll( log, 0 ) > 0 )
+                        ;
+
+                    RTL_TEST( log.count == 3 );
+                    RTL_TEST( log.events( watch_action::removed, first ) == 1 );
+                    RTL_TEST( log.events( watch_action::removed, keep ) == 1 );
+                    RTL_TEST( log.events( watch_action::removed, renamed ) == 1 );
+
+                    w.close();
+                    ::RemoveDirectoryW( watched.c_str() );
+                }
+
+                // Completed requests and their bytes, see test_async_file
+                struct completions
+                {
+                    int    calls;
+                    size_t bytes;
+                };
+
+                void count_completion( rtl::filesystem::io_request& request, void* context )
+                {
+                    completions& result = *static_cast<completions*>( context );
+                    ++result.calls;
+                    result.bytes += request.bytes();
+                }
+
+                void test_async_file( const path& directory )
+                {
+                    using rtl::filesystem::async_file;
+                    using rtl::filesystem::io_queue;
+                    using rtl::filesystem::io_request;
+
+                    // NOTE: the blocks are submitted out of order, all of them in flight at once
+                    constexpr int    block_count = 4;
+                    constexpr size_t block_size = 256;
+                    constexpr size_t file_size = block_count * block_size;
+                    constexpr int    order[block_count] = { 3, 1, 0, 2 };
+
+                    uint8_t content[file_size];
+                    for ( size_t i = 0; i < file_size; ++i )
+                        content[i] = pattern( i );
+
+                    const path name = directory / L"async.bin";
+                    io_queue   queue;
+                    io_request requests[block_count];
+
+                    {
+                        async_file  file;
+                        completions written = {};
+                        RTL_TEST( file.open( queue, name, async_file::mode::write ) );
+
+                        for ( int block : order )
+                        {
+                            const size_t offset = block * block_size;
+                            RTL_TEST( file.write_at( requests[block],
+                                                     offset,
+                                                     content + offset,
+                                                     block_size,
+                                                     count_completion,
+                                                     &written ) );
+                        }
+
+                        RTL_TEST( queue.pending() == block_count );
+                        queue.wait();
+                        RTL_TEST( queue.pending() == 0 );
+
+                        for ( const io_request& request : requests )
+                        {
+                            RTL_TEST( request.pending() == false );
+                            RTL_TEST( request.error() == 0 );
+                            RTL_TEST( request.bytes() == block_size );
+                        }
+
+                        RTL_TEST( written.calls == block_count );
+                        RTL_TEST( written.bytes == file_size );
+                        RTL_TEST( file.size() == file_size );
+                    }
+
+                    {
+                        async_file  file;
+                        completions read = {};
+                        RTL_TEST( file.open( queue, name ) );
+
+                        uint8_t buffer[file_size + block_size] = {};
+
+                        for ( int block : order )
+                        {
+                            const size_t offset = block * block_size;
+                            RTL_TEST( file.read_at( requests[block],
+                                                    offset,
+                                                    buffer + offset,
+                                                    block_size,
+                                                    count_completion,
+                                                    &read ) );
+                        }
+
+                        // A read across the end of the file transfers only its part
+                        io_request tail;
+                        const size_t tail_offset = file_size - block_size / 2;
+                        RTL_TEST(
+                            file.read_at( tail, tail_offset, buffer + file_size, block_size ) );
+
+                        queue.wait();
+
+                        for ( const io_request& request : requests )
+                        {
+                            RTL_TEST( request.error() == 0 );
+                            RTL_TEST( request.bytes() == block_size );
+                        }
+
+                        RTL_TEST( read.calls == block_count );
+                        RTL_TEST( read.bytes == file_size );
+                        RTL_TEST( tail.pending() == false && tail.error() == 0 );
+                        RTL_TEST( tail.bytes() == block_size / 2 );
+
+                        bool same = true;
+                        for ( size_t i = 0; i < file_size; ++i )
+                            same = same && buffer[i] == pattern( i );
+
+                        for ( size_t i = 0; i < block_size / 2; ++i )
+                            same = same && buffer[file_size + i] == pattern( tail_offset + i );
+
+                        RTL_TEST( same );
+                    }
+
+                    ::DeleteFileW( name.c_str() );
+                }
+
                 void run()
                 {
                     rtl::filesystem::directory_entry de;
@@ -80,15 +1652,112 @@ namespace rtl
                     RTL_TEST( de.is_directory() == false );
                     RTL_TEST( de.is_regular_file() == false );
                     RTL_TEST( de.file_size() == 0 );
+                    RTL_TEST( de.last_write_time() == 0 );
 
                     rtl::filesystem::path p( L"name.ext" );
                     RTL_TEST( p.extension().wstring() == L".ext" );
+                    RTL_TEST( ( p / L"sub" ).wstring() == L"name.ext/sub" );
+                    RTL_TEST( ( rtl::filesystem::path_view( L"dir/" ) / L"sub" ) == L"dir/sub" );
+
+                    int                        segments = 0;
+                    rtl::filesystem::path_view segmented( L"/a//b/" );
+                    for ( rtl::filesystem::path_view segment : segmented )
+                        RTL_TEST( segment == ( segments++ == 0 ? L"a" : L"b" ) );
+
+                    RTL_TEST( segments == 2 );
+
+                    rtl::filesystem::directory_iterator end;
+                    rtl::filesystem::directory_iterator missing{ rtl::filesystem::path(
+                        L"?:/nonexistent" ) };
+                    RTL_TEST( missing == end );
+
+                    rtl::filesystem::recursive_directory_iterator recursive_end;
+                    rtl::filesystem::recursive_directory_iterator recursive_missing{
+                        rtl::filesystem::path( L"?:/nonexistent" ) };
+                    RTL_TEST( recursive_missing == recursive_end );
+
+                    int  visited = 0;
+                    auto visitor = [&visited]( const rtl::filesystem::walk_entry& )
+                    {
+                        ++visited;
+                    };
+
+                    rtl::filesystem::walk( rtl::filesystem::path( L"?:/nonexistent" ), visitor );
+                    RTL_TEST( visited == 0 );
+
+                    rtl::filesystem::mapped_file mf;
+                    RTL_TEST( mf.is_open() == false );
+                    RTL_TEST( mf.size() == 0 );
+                    RTL_TEST( mf.view().empty() );
+                    RTL_TEST( mf.open( rtl::filesystem::path( L"?:/nonexistent" ) ) == false );
+                    RTL_TEST( mf.is_open() == false );
+
+                    rtl::filesystem::stream_reader sr;
+                    RTL_TEST( sr.is_open() == false );
+                    RTL_TEST( sr.next().empty() );
+                    RTL_TEST( sr.open( rtl::filesystem::path( L"?:/nonexistent" ) ) == false );
+                    RTL_TEST( sr.failed() == false );
+
+                    rtl::filesystem::file_writer fw;
+                    RTL_TEST( fw.is_open() == false );
+                    RTL_TEST( fw.open( rtl::filesystem::path( L"?:/nonexistent" ),
+                                       rtl::filesystem::file_writer::mode::atomic )
+                              == false );
+                    RTL_TEST( fw.size() == 0 );
+
+                    rtl::filesystem::file_cache cache( 1024 );
+                    RTL_TEST( cache.get( rtl::filesystem::path( L"?:/nonexistent" ) ).empty() );
+                    RTL_TEST( cache.stats().misses == 1 );
+                    RTL_TEST( cache.count() == 0 );
+
+                    rtl::filesystem::watcher watcher;
+                    RTL_TEST( watcher.is_open() == false );
+                    RTL_TEST( watcher.handle() == nullptr );
+                    RTL_TEST( watcher.open( rtl::filesystem::path( L"?:/nonexistent" ) ) == false );
+
+                    rtl::filesystem::io_queue queue;
+                    RTL_TEST( queue.pending() == 0 );
+                    RTL_TEST( queue.poll() == 0 );
+
+                    rtl::filesystem::async_file af;
+                    RTL_TEST( af.is_open() == false );
+                    RTL_TEST( af.open( queue, rtl::filesystem::path( L"?:/nonexistent" ) )
+                              == false );
+                    RTL_TEST( af.size() == 0 );
+
+                    const path directory = scratch_directory();
+
+                    test_mapped_file( directory );
+                    test_stream_reader( directory );
+                    test_file_writer( directory );
+                    test_file_cache( directory );
+                    test_directory_iterator( directory );
+                    test_recursive_directory_iterator( directory );
+                    test_walk( directory );
+                    test_async_file( directory );
+                    test_watcher( directory );
+
+                    ::RemoveDirectoryW( directory.c_str() );
                 }
             } // namespace filesystem
 
             void run()
             {
+                algorithm::run();
+    #if RTL_ENABLE_MEMSET
+                memory::run();
+    #endif
+                bit::run();
+                fix::run();
+                random::run();
+                noise::run();
                 string::run();
+                utf::run();
+                hash::run();
+                charconv::run();
+                archive::run();
+                riff::run();
+                lz4::run();
                 filesystem::run();
             }
         } // namespace runtime_tests
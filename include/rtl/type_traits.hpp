@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+namespace rtl
+{
+    template<typename T, T Value>
+    struct integral_constant
+    {
+        static constexpr T value = Value;
+    };
+
+    using true_type = integral_constant<bool, true>;
+    using false_type = integral_constant<bool, false>;
+
+    template<typename T>
+    struct remove_cv
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    struct remove_cv<const T>
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    struct remove_cv<volatile T>
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    struct remove_cv<const volatile T>
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    using remove_cv_t = typename remove_cv<T>::type;
+
+    // NOTE: also blocks template argument deduction
+    template<typename T>
+    struct type_identity
+    {
+        using type = T;
+    };
+
+    template<typename T>
+    using type_identity_t = typename type_identity<T>::type;
+
+    template<typename T, typename U>
+    struct is_same : false_type
+    {
+    };
+
+    template<typename T>
+    struct is_same<T, T> : true_type
+    {
+    };
+
+    template<typename T, typename U>
+    inline constexpr bool is_same_v = is_same<T, U>::value;
+
+    namespace impl
+    {
+        template<typename T>
+        struct is_integral : false_type
+        {
+        };
+
+        // clang-format off
+        template<> struct is_integral<bool> : true_type {};
+        template<> struct is_integral<char> : true_type {};
+        template<> struct is_integral<signed char> : true_type {};
+        template<> struct is_integral<unsigned char> : true_type {};
+        template<> struct is_integral<wchar_t> : true_type {};
+        template<> struct is_integral<char16_t> : true_type {};
+        template<> struct is_integral<char32_t> : true_type {};
+        template<> struct is_integral<short> : true_type {};
+        template<> struct is_integral<unsigned short> : true_type {};
+        template<> struct is_integral<int> : true_type {};
+        template<> struct is_integral<unsigned int> : true_type {};
+        template<> struct is_integral<long> : true_type {};
+        template<> struct is_integral<unsigned long> : true_type {};
+        template<> struct is_integral<long long> : true_type {};
+        template<> struct is_integral<unsigned long long> : true_type {};
+        // clang-format on
+    } // namespace impl
+
+    template<typename T>
+    struct is_integral : impl::is_integral<remove_cv_t<T>>
+    {
+    };
+
+    template<typename T>
+    inline constexpr bool is_integral_v = is_integral<T>::value;
+
+    namespace impl
+    {
+        template<typename T, bool = is_integral_v<T>>
+        struct is_unsigned : integral_constant<bool, ( T( -1 ) > T( 0 ) )>
+        {
+        };
+
+        template<typename T>
+        struct is_unsigned<T, false> : false_type
+        {
+        };
+    } // namespace impl
+
+    template<typename T>
+    struct is_unsigned : impl::is_unsigned<remove_cv_t<T>>
+    {
+    };
+
+    template<typename T>
+    inline constexpr bool is_unsigned_v = is_unsigned<T>::value;
+
+    template<typename T>
+    struct is_trivially_copyable : integral_constant<bool, __is_trivially_copyable( T )>
+    {
+    };
+
+    template<typename T>
+    inline constexpr bool is_trivially_copyable_v = is_trivially_copyable<T>::value;
+
+    template<typename T>
+    struct is_trivially_destructible
+#if defined( __GNUC__ ) && !defined( __clang__ )
+        : integral_constant<bool, __has_trivial_destructor( T )>
+#else
+        : integral_constant<bool, __is_trivially_destructible( T )>
+#endif
+    {
+    };
+
+    template<typename T>
+    inline constexpr bool is_trivially_destructible_v = is_trivially_destructible<T>::value;
+
+    [[nodiscard]] constexpr bool is_constant_evaluated()
+    {
+        return __builtin_is_constant_evaluated();
+    }
+} // namespace rtl
@@ -0,0 +1,412 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+#pragma once
+
+#include <rtl/int.hpp>
+#include <rtl/string.hpp>
+#include <rtl/type_traits.hpp>
+
+#if RTL_ENABLE_SIMD
+    #include <emmintrin.h>
+#endif
+
+namespace rtl
+{
+    // Result of checked conversions on malformed input
+    constexpr size_t utf_error = static_cast<size_t>( -1 );
+
+    namespace impl
+    {
+        namespace utf
+        {
+            constexpr uint32_t replacement = 0xfffd;
+            constexpr uint32_t invalid = 0xffffffff;
+
+            // Decodes one code point, 'length' receives the number of consumed bytes
+            [[nodiscard]] constexpr uint32_t decode_utf8( const char* p,
+                                                          size_t      left,
+                                                          size_t&     length )
+            {
+                const uint8_t lead = static_cast<uint8_t>( p[0] );
+
+                length = 1;
+
+                if ( lead < 0x80 )
+                    return lead;
+
+                if ( lead < 0xc2 || lead > 0xf4 )
+                    return invalid;
+
+                const size_t size = lead < 0xe0 ? 2 : lead < 0xf0 ? 3 : 4;
+
+                if ( left < size )
+                    return invalid;
+
+                uint32_t code = lead & ( 0x7f >> size );
+
+                for ( size_t i = 1; i < size; ++i )
+                {
+                    const uint8_t c = static_cast<uint8_t>( p[i] );
+
+                    if ( ( c & 0xc0 ) != 0x80 )
+                        return invalid;
+
+                    code = ( code << 6 ) | ( c & 0x3f );
+                }
+
+                // Overlong forms, surrogates and values above U+10FFFF
+                if ( size == 3 && ( code < 0x800 || ( code >= 0xd800 && code <= 0xdfff ) ) )
+                    return invalid;
+
+                if ( size == 4 && ( code < 0x10000 || code > 0x10ffff ) )
+                    return invalid;
+
+                length = size;
+                return code;
+            }
+
+            // Encodes one code point, returns the number of bytes
+            [[nodiscard]] constexpr size_t encode_utf8( uint32_t code, char* dst )
+            {
+                if ( code < 0x80 )
+                {
+                    if ( dst )
+                        dst[0] = static_cast<char>( code );
+
+                    return 1;
+                }
+
+                if ( code < 0x800 )
+                {
+                    if ( dst )
+                    {
+                        dst[0] = static_cast<char>( 0xc0 | ( code >> 6 ) );
+                        dst[1] = static_cast<char>( 0x80 | ( code & 0x3f ) );
+                    }
+
+                    return 2;
+                }
+
+                if ( code < 0x10000 )
+                {
+                    if ( dst )
+                    {
+                        dst[0] = static_cast<char>( 0xe0 | ( code >> 12 ) );
+                        dst[1] = static_cast<char>( 0x80 | ( ( code >> 6 ) & 0x3f ) );
+                        dst[2] = static_cast<char>( 0x80 | ( code & 0x3f ) );
+                    }
+
+                    return 3;
+                }
+
+                if ( dst )
+                {
+                    dst[0] = static_cast<char>( 0xf0 | ( code >> 18 ) );
+                    dst[1] = static_cast<char>( 0x80 | ( ( code >> 12 ) & 0x3f ) );
+                    dst[2] = static_cast<char>( 0x80 | ( ( code >> 6 ) & 0x3f ) );
+                    dst[3] = static_cast<char>( 0x80 | ( code & 0x3f ) );
+                }
+
+                return 4;
+            }
+
+            // Decodes one code point from UTF-16 or UTF-32
+            template<typename Wide>
+            [[nodiscard]] constexpr uint32_t decode_wide( const Wide* p,
+                                                          size_t      left,
+                                                          size_t&     length )
+            {
+                const uint32_t code = static_cast<uint32_t>( p[0] );
+
+                length = 1;
+
+                if ( code >= 0xd800 && code <= 0xdfff )
+                {
+                    if constexpr ( sizeof( Wide ) == 2 )
+                    {
+                        if ( code <= 0xdbff && left >= 2 )
+                        {
+                            const uint32_t low = static_cast<uint32_t>( p[1] );
+
+                            if ( low >= 0xdc00 && low <= 0xdfff )
+                            {
+                                length = 2;
+                                return 0x10000 + ( ( code - 0xd800 ) << 10 ) + ( low - 0xdc00 );
+                            }
+                        }
+                    }
+
+                    return invalid;
+                }
+
+                return code > 0x10ffff ? invalid : code;
+            }
+
+            // Encodes one code point to UTF-16 or UTF-32, returns the number of characters
+            template<typename Wide>
+            [[nodiscard]] constexpr size_t encode_wide( uint32_t code, Wide* dst )
+            {
+                if constexpr ( sizeof( Wide ) == 2 )
+                {
+                    if ( code >= 0x10000 )
+                    {
+                        if ( dst )
+                        {
+                            dst[0] = static_cast<Wide>( 0xd800 + ( ( code - 0x10000 ) >> 10 ) );
+                            dst[1] = static_cast<Wide>( 0xdc00 + ( code & 0x3ff ) );
+                        }
+
+                        return 2;
+                    }
+                }
+
+                if ( dst )
+                    dst[0] = static_cast<Wide>( code );
+
+                return 1;
+            }
+
+#if RTL_ENABLE_SIMD
+            // Widens leading ASCII characters 16 at a time, returns their count
+            template<typename Wide>
+            size_t widen_ascii( const char* src, size_t size, Wide* dst )
+            {
+                const __m128i zero = _mm_setzero_si128();
+
+                size_t i = 0;
+
+                for ( ; i + 16 <= size; i += 16 )
+                {
+                    const __m128i bytes
+                        = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+
+                    if ( _mm_movemask_epi8( bytes ) != 0 )
+                        break;
+
+                    if ( !dst )
+                        continue;
+
+                    const __m128i lo = _mm_unpacklo_epi8( bytes, zero );
+                    const __m128i hi = _mm_unpackhi_epi8( bytes, zero );
+
+                    __m128i* out = reinterpret_cast<__m128i*>( dst + i );
+
+                    if constexpr ( sizeof( Wide ) == 2 )
+                    {
+                        _mm_storeu_si128( out, lo );
+                        _mm_storeu_si128( out + 1, hi );
+                    }
+                    else
+                    {
+                        _mm_storeu_si128( out, _mm_unpacklo_epi16( lo, zero ) );
+                        _mm_storeu_si128( out + 1, _mm_unpackhi_epi16( lo, zero ) );
+                        _mm_storeu_si128( out + 2, _mm_unpacklo_epi16( hi, zero ) );
+                        _mm_storeu_si128( out + 3, _mm_unpackhi_epi16( hi, zero ) );
+                    }
+                }
+
+                return i;
+            }
+
+            // Narrows leading ASCII characters 16 at a time, returns their count
+            template<typename Wide>
+            size_t narrow_ascii( const Wide* src, size_t size, char* dst )
+            {
+                const __m128i* in = reinterpret_cast<const __m128i*>( src );
+
+                size_t i = 0;
+
+                for ( ; i + 16 <= size; i += 16, in += sizeof( Wide ) )
+                {
+                    __m128i bytes;
+
+                    if constexpr ( sizeof( Wide ) == 2 )
+                    {
+                        const __m128i a = _mm_loadu_si128( in );
+                        const __m128i b = _mm_loadu_si128( in + 1 );
+
+                        const __m128i high = _mm_and_si128(
+                            _mm_or_si128( a, b ), _mm_set1_epi16( static_cast<short>( 0xff80 ) ) );
+
+                        if ( _mm_movemask_epi8( _mm_cmpeq_epi8( high, _mm_setzero_si128() ) )
+                             != 0xffff )
+                            break;
+
+                        bytes = _mm_packus_epi16( a, b );
+                    }
+                    else
+                    {
+                        const __m128i a = _mm_loadu_si128( in );
+                        const __m128i b = _mm_loadu_si128( in + 1 );
+                        const __m128i c = _mm_loadu_si128( in + 2 );
+                        const __m128i d = _mm_loadu_si128( in + 3 );
+
+                        const __m128i high = _mm_and_si128(
+                            _mm_or_si128( _mm_or_si128( a, b ), _mm_or_si128( c, d ) ),
+                            _mm_set1_epi32( static_cast<int>( 0xffffff80 ) ) );
+
+                        if ( _mm_movemask_epi8( _mm_cmpeq_epi8( high, _mm_setzero_si128() ) )
+                             != 0xffff )
+                            break;
+
+                        bytes = _mm_packus_epi16( _mm_packs_epi32( a, b ),
+                                                  _mm_packs_epi32( c, d ) );
+                    }
+
+                    if ( dst )
+                        _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), bytes );
+                }
+
+                return i;
+            }
+#endif
+
+            template<bool Checked, typename Wide>
+            [[nodiscard]] constexpr size_t utf8_to_wide( const char* src, size_t size, Wide* dst )
+            {
+                size_t count = 0;
+
+                for ( size_t i = 0; i < size; )
+                {
+                    if ( static_cast<uint8_t>( src[i] ) < 0x80 )
+                    {
+#if RTL_ENABLE_SIMD
+                        if ( !rtl::is_constant_evaluated() )
+                        {
+                            const size_t ascii
+                                = widen_ascii( src + i, size - i, dst ? dst + count : dst );
+
+                            i += ascii;
+                            count += ascii;
+                        }
+#endif
+                        for ( ; i < size && static_cast<uint8_t>( src[i] ) < 0x80; ++i, ++count )
+                            if ( dst )
+                                dst[count] = static_cast<Wide>( src[i] );
+
+                        continue;
+                    }
+
+                    size_t   length = 0;
+                    uint32_t code = decode_utf8( src + i, size - i, length );
+
+                    if ( code == invalid )
+                    {
+                        if constexpr ( Checked )
+                            return utf_error;
+
+                        code = replacement;
+                    }
+
+                    count += encode_wide( code, dst ? dst + count : dst );
+                    i += length;
+                }
+
+                return count;
+            }
+
+            template<bool Checked, typename Wide>
+            [[nodiscard]] constexpr size_t wide_to_utf8( const Wide* src, size_t size, char* dst )
+            {
+                size_t count = 0;
+
+                for ( size_t i = 0; i < size; )
+                {
+                    if ( static_cast<uint32_t>( src[i] ) < 0x80 )
+                    {
+#if RTL_ENABLE_SIMD
+                        if ( !rtl::is_constant_evaluated() )
+                        {
+                            const size_t ascii
+                                = narrow_ascii( src + i, size - i, dst ? dst + count : dst );
+
+                            i += ascii;
+                            count += ascii;
+                        }
+#endif
+                        for ( ; i < size && static_cast<uint32_t>( src[i] ) < 0x80; ++i, ++count )
+                            if ( dst )
+                                dst[count] = static_cast<char>( src[i] );
+
+                        continue;
+                    }
+
+                    size_t   length = 0;
+                    uint32_t code = decode_wide( src + i, size - i, length );
+
+                    if ( code == invalid )
+                    {
+                        if constexpr ( Checked )
+                            return utf_error;
+
+                        code = replacement;
+                    }
+
+                    count += encode_utf8( code, dst ? dst + count : dst );
+                    i += length;
+                }
+
+                return count;
+            }
+        } // namespace utf
+    }     // namespace impl
+
+    // Converts UTF-8 to UTF-16 or UTF-32, depending on the size of the wide character type.
+    // Returns the number of written characters; without 'dst' only counts them, so the output
+    // can be allocated exactly. Malformed sequences are replaced with U+FFFD.
+    template<typename Wide = wchar_t>
+    [[nodiscard]] constexpr size_t utf8_to_wide( const char* src, size_t size, Wide* dst = nullptr )
+    {
+        return impl::utf::utf8_to_wide<false>( src, size, dst );
+    }
+
+    // Same as utf8_to_wide, but returns utf_error on malformed input
+    template<typename Wide = wchar_t>
+    [[nodiscard]] constexpr size_t utf8_to_wide_checked( const char* src,
+                                                         size_t      size,
+                                                         Wide*       dst = nullptr )
+    {
+        return impl::utf::utf8_to_wide<true>( src, size, dst );
+    }
+
+    // Converts UTF-16 or UTF-32 to UTF-8, returns the number of written bytes; without 'dst'
+    // only counts them. Unpaired surrogates are replaced with U+FFFD.
+    template<typename Wide>
+    [[nodiscard]] constexpr size_t wide_to_utf8( const Wide* src, size_t size, char* dst = nullptr )
+    {
+        return impl::utf::wide_to_utf8<false>( src, size, dst );
+    }
+
+    // Same as wide_to_utf8, but returns utf_error on malformed input
+    template<typename Wide>
+    [[nodiscard]] constexpr size_t wide_to_utf8_checked( const Wide* src,
+                                                         size_t      size,
+                                                         char*       dst = nullptr )
+    {
+        return impl::utf::wide_to_utf8<true>( src, size, dst );
+    }
+
+    [[nodiscard]] inline wstring utf8_to_wide( const string_view& src )
+    {
+        wstring result( utf8_to_wide( src.data(), src.size() ), 0 );
+        (void)utf8_to_wide( src.data(), src.size(), result.data() );
+
+        return result;
+    }
+
+    [[nodiscard]] inline string wide_to_utf8( const wstring_view& src )
+    {
+        string result( wide_to_utf8( src.data(), src.size() ), 0 );
+        (void)wide_to_utf8( src.data(), src.size(), result.data() );
+
+        return result;
+    }
+} // namespace rtl
@@ -0,0 +1,231 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+
+// Compresses a file into an LZ4 block for rtl::lz4_decompress, see <rtl/lz4.hpp>.
+//
+// Usage: rtl_lz4 [-d] <input> <output>
+//
+// The output is the decompressed size as 32-bit little-endian, followed by the block.
+// With -d such a file is decompressed back, through the library decoder.
+
+#include <rtl/lz4.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+    using bytes = std::vector<unsigned char>;
+
+    constexpr std::size_t hash_bits = 16;
+    constexpr std::size_t min_match = 4;
+    constexpr std::size_t max_offset = 65535;
+
+    // The last match must start this far from the end, the last 5 bytes are always literals
+    constexpr std::size_t match_start_limit = 12;
+    constexpr std::size_t last_literals = 5;
+
+    std::uint32_t read32( const unsigned char* p )
+    {
+        std::uint32_t value;
+        std::memcpy( &value, p, sizeof( value ) );
+        return value;
+    }
+
+    std::size_t hash( std::uint32_t sequence )
+    {
+        return ( sequence * 2654435761u ) >> ( 32 - hash_bits );
+    }
+
+    void write_length( bytes& out, std::size_t length )
+    {
+        for ( ; length >= 255; length -= 255 )
+            out.push_back( 255 );
+
+        out.push_back( static_cast<unsigned char>( length ) );
+    }
+
+    void write_sequence( bytes&               out,
+                         const unsigned char* literals,
+                         std::size_t          literal_length,
+                         std::size_t          offset,
+                         std::size_t          match_length )
+    {
+        // NOTE: the last sequence has no match, its token carries a zero match nibble
+        const std::size_t match_code = match_length != 0 ? match_length - min_match : 0;
+
+        const std::size_t token = ( std::min<std::size_t>( literal_length, 15 ) << 4 )
+                                  | std::min<std::size_t>( match_code, 15 );
+        out.push_back( static_cast<unsigned char>( token ) );
+
+        if ( literal_length >= 15 )
+            write_length( out, literal_length - 15 );
+
+        out.insert( out.end(), literals, literals + literal_length );
+
+        if ( match_length == 0 )
+            return;
+
+        out.push_back( static_cast<unsigned char>( offset ) );
+        out.push_back( static_cast<unsigned char>( offset >> 8 ) );
+
+        if ( match_code >= 15 )
+            write_length( out, match_code - 15 );
+    }
+
+    // Greedy parse with a single-entry hash table, the way the reference fast mode does it
+    bytes compress( const bytes& in )
+    {
+        bytes out;
+        out.reserve( rtl::lz4_compress_bound( static_cast<rtl::size_t>( in.size() ) ) );
+
+        const unsigned char* src = in.data();
+        const std::size_t    size = in.size();
+
+        std::size_t anchor = 0;
+
+        if ( size > match_start_limit )
+        {
+            // Positions are stored plus one, zero is an empty slot
+            std::vector<std::uint32_t> table( std::size_t( 1 ) << hash_bits );
+
+            const std::size_t limit = size - match_start_limit;
+            const std::size_t match_limit = size - last_literals;
+
+            for ( std::size_t pos = 0; pos < limit; )
+            {
+                const std::uint32_t sequence = read32( src + pos );
+                std::uint32_t&      slot = table[hash( sequence )];
+
+                const std::size_t candidate = slot;
+                slot = static_cast<std::uint32_t>( pos + 1 );
+
+                if ( candidate == 0 || pos - ( candidate - 1 ) > max_offset
+                     || read32( src + candidate - 1 ) != sequence )
+                {
+                    ++pos;
+                    continue;
+                }
+
+                const std::size_t match = candidate - 1;
+
+                std::size_t length = min_match;
+                while ( pos + length < match_limit && src[match + length] == src[pos + length] )
+                    ++length;
+
+                write_sequence( out, src + anchor, pos - anchor, pos - match, length );
+
+                pos += length;
+                anchor = pos;
+            }
+        }
+
+        write_sequence( out, src + anchor, size - anchor, 0, 0 );
+
+        return out;
+    }
+
+    bool read_file( const char* name, bytes& content )
+    {
+        std::ifstream file( name, std::ios::binary );
+
+        if ( !file )
+            return false;
+
+        content.assign( std::istreambuf_iterator<char>( file ), std::istreambuf_iterator<char>() );
+        return true;
+    }
+
+    bool write_file( const char* name, const bytes& content )
+    {
+        std::ofstream file( name, std::ios::binary | std::ios::trunc );
+        file.write( reinterpret_cast<const char*>( content.data() ), content.size() );
+        return static_cast<bool>( file.flush() );
+    }
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+    const bool decompress = argc == 4 && std::strcmp( argv[1], "-d" ) == 0;
+
+    if ( argc != 3 && !decompress )
+    {
+        std::fprintf( stderr, "Usage: rtl_lz4 [-d] <input> <output>\n" );
+        return 2;
+    }
+
+    const char* input = argv[argc - 2];
+    const char* output = argv[argc - 1];
+
+    bytes in;
+
+    if ( !read_file( input, in ) )
+    {
+        std::fprintf( stderr, "rtl_lz4: can not read %s\n", input );
+        return 1;
+    }
+
+    bytes out;
+
+    if ( decompress )
+    {
+        if ( in.size() < 4 )
+        {
+            std::fprintf( stderr, "rtl_lz4: %s is not compressed\n", input );
+            return 1;
+        }
+
+        out.resize( in[0] | ( in[1] << 8 ) | ( in[2] << 16 ) | ( std::size_t( in[3] ) << 24 ) );
+
+        const rtl::span<const rtl::uint8_t> block( in.data() + 4,
+                                                   static_cast<rtl::size_t>( in.size() - 4 ) );
+        const rtl::span<rtl::uint8_t> result( out.data(), static_cast<rtl::size_t>( out.size() ) );
+
+        if ( rtl::lz4_decompress( block, result ) != out.size() )
+        {
+            std::fprintf( stderr, "rtl_lz4: %s is corrupted\n", input );
+            return 1;
+        }
+    }
+    else
+    {
+        if ( in.size() > 0xFFFFFFFFu )
+        {
+            std::fprintf( stderr, "rtl_lz4: %s is too large\n", input );
+            return 1;
+        }
+
+        const std::size_t size = in.size();
+
+        out = { static_cast<unsigned char>( size ),
+                static_cast<unsigned char>( size >> 8 ),
+                static_cast<unsigned char>( size >> 16 ),
+                static_cast<unsigned char>( size >> 24 ) };
+
+        const bytes block = compress( in );
+        out.insert( out.end(), block.begin(), block.end() );
+
+        std::printf( "rtl_lz4: %zu -> %zu bytes\n", in.size(), out.size() );
+    }
+
+    if ( !write_file( output, out ) )
+    {
+        std::fprintf( stderr, "rtl_lz4: can not write %s\n", output );
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright (C) 2016-2022 Konstantin Polevik
+ * All rights reserved
+ *
+ * This file is part of the RTL library. Redistribution and use in source and
+ * binary forms, with or without modification, are permitted exclusively
+ * under the terms of the MIT license. You should have received a copy of the
+ * license with this file. If not, please visit:
+ * https://github.com/out61h/rtl/blob/main/LICENSE.
+ */
+
+// Packs a directory tree into an archive, see <rtl/archive.hpp>.
+//
+// Usage: rtl_pack <directory> <archive>
+//
+// Names are paths relative to the directory with '/' separators. The type tag of a file is its
+// extension, upper-cased and padded with spaces: "logo.png" is tagged 'PNG '.
+
+#include <rtl/archive.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    namespace fs = std::filesystem;
+
+    struct input
+    {
+        std::string   name;
+        fs::path      path;
+        rtl::uint32_t type;
+        rtl::uint32_t size;
+    };
+
+    rtl::uint32_t type_of( const fs::path& path )
+    {
+        const std::string extension = path.extension().u8string();
+
+        char tag[4] = { ' ', ' ', ' ', ' ' };
+
+        for ( std::size_t i = 1; i < extension.size() && i <= 4; ++i )
+        {
+            const unsigned char c = static_cast<unsigned char>( extension[i] );
+            tag[i - 1] = static_cast<char>( std::toupper( c ) );
+        }
+
+        return rtl::make_fourcc( tag[0], tag[1], tag[2], tag[3] );
+    }
+
+    std::uint64_t align( std::uint64_t offset )
+    {
+        const std::uint64_t mask = rtl::archive_alignment - 1;
+        return ( offset + mask ) & ~mask;
+    }
+
+    bool fail( const char* message, const std::string& what )
+    {
+        std::fprintf( stderr, "rtl_pack: %s: %s\n", message, what.c_str() );
+        return false;
+    }
+
+    bool pack( const fs::path& directory, const fs::path& output )
+    {
+        std::vector<input> inputs;
+
+        std::error_code error;
+
+        for ( fs::recursive_directory_iterator it( directory, error ), end; !error && it != end;
+              it.increment( error ) )
+        {
+            if ( !it->is_regular_file() )
+                continue;
+
+            const std::uintmax_t size = it->file_size();
+
+            if ( size > 0xFFFFFFFFu )
+                return fail( "file is too large", it->path().u8string() );
+
+            inputs.push_back( input{ it->path().lexically_relative( directory ).generic_u8string(),
+                                     it->path(),
+                                     type_of( it->path() ),
+                                     static_cast<rtl::uint32_t>( size ) } );
+        }
+
+        if ( error )
+            return fail( error.message().c_str(), directory.u8string() );
+
+        // NOTE: std::string compares as unsigned bytes, which is the order the reader expects
+        std::sort( inputs.begin(),
+                   inputs.end(),
+                   []( const input& a, const input& b )
+                   {
+                       return a.name < b.name;
+                   } );
+
+        rtl::archive_header header = { rtl::archive_magic,
+                                       rtl::archive_version,
+                                       static_cast<rtl::uint32_t>( inputs.size() ),
+                                       0 };
+
+        std::vector<rtl::archive_entry> entries;
+        std::string                     names;
+
+        for ( const input& i : inputs )
+        {
+            entries.push_back( rtl::archive_entry{ static_cast<rtl::uint32_t>( names.size() ),
+                                                   static_cast<rtl::uint32_t>( i.name.size() ),
+                                                   i.type,
+                                                   0,
+                                                   i.size } );
+            names += i.name;
+        }
+
+        header.names_size = static_cast<rtl::uint32_t>( names.size() );
+
+        std::uint64_t offset = sizeof( header ) + entries.size() * sizeof( rtl::archive_entry )
+                               + names.size();
+
+        for ( rtl::archive_entry& e : entries )
+        {
+            offset = align( offset );
+            e.offset = static_cast<rtl::uint32_t>( offset );
+            offset += e.size;
+
+            if ( offset > 0xFFFFFFFFu )
+                return fail( "archive is too large", output.u8string() );
+        }
+
+        std::ofstream file( output, std::ios::binary | std::ios::trunc );
+
+        if ( !file )
+            return fail( "can not create", output.u8string() );
+
+        file.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+        file.write( reinterpret_cast<const char*>( entries.data() ),
+                    entries.size() * sizeof( rtl::archive_entry ) );
+        file.write( names.data(), names.size() );
+
+        std::vector<char> content;
+
+        for ( std::size_t i = 0; i < inputs.size(); ++i )
+        {
+            const std::streamoff padding = entries[i].offset - std::streamoff( file.tellp() );
+            file.write( "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", padding );
+
+            std::ifstream source( inputs[i].path, std::ios::binary );
+            content.resize( inputs[i].size );
+
+            if ( !source.read( content.data(), content.size() ) )
+                return fail( "can not read", inputs[i].path.u8string() );
+
+            file.write( content.data(), content.size() );
+        }
+
+        if ( !file.flush() )
+            return fail( "can not write", output.u8string() );
+
+        std::printf( "rtl_pack: %zu files, %llu bytes\n",
+                     inputs.size(),
+                     static_cast<unsigned long long>( offset ) );
+
+        return true;
+    }
+} // namespace
+
+int main( int argc, char* argv[] )
+{
+    if ( argc != 3 )
+    {
+        std::fprintf( stderr, "Usage: rtl_pack <directory> <archive>\n" );
+        return 2;
+    }
+
+    return pack( fs::u8path( argv[1] ), fs::u8path( argv[2] ) ) ? 0 : 1;
+}